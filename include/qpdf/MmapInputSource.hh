@@ -0,0 +1,81 @@
+// Copyright (c) 2005-2021 Jay Berkenbilt
+// Copyright (c) 2022-2025 Jay Berkenbilt and Manfred Holger
+//
+// This file is part of qpdf.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under
+// the License.
+//
+// Versions of qpdf prior to version 7 were released under the terms of version 2.0 of the Artistic
+// License. At your option, you may continue to consider qpdf to be licensed under those terms.
+// Please see the manual for additional information.
+
+#ifndef QPDF_MMAPINPUTSOURCE_HH
+#define QPDF_MMAPINPUTSOURCE_HH
+
+#include <qpdf/InputSource.hh>
+
+#include <string_view>
+
+// This is an input source that reads from a file that has been mapped into memory. All reads are
+// served directly from the mapping, so reading does not require a system call or a trip through
+// stdio buffers. The file is mapped read-only for the lifetime of the input source, so it must not
+// be truncated or otherwise modified while the input source is in use.
+//
+// The constructor throws a std::runtime_error (usually a QPDFSystemError) if the file can't be
+// opened or mapped, e.g. because the platform doesn't support memory mapping or the file is too
+// large to map into the address space. Callers that want to transparently fall back to
+// FileInputSource should catch the exception. This is what QPDF::processFile does when
+// QPDF::setUseMmap(true) has been called.
+class QPDF_DLL_CLASS MmapInputSource: public InputSource
+{
+  public:
+    QPDF_DLL
+    MmapInputSource(char const* filename);
+
+    MmapInputSource(MmapInputSource const&) = delete;
+    MmapInputSource& operator=(MmapInputSource const&) = delete;
+
+    QPDF_DLL
+    ~MmapInputSource() override;
+    QPDF_DLL
+    qpdf_offset_t findAndSkipNextEOL() override;
+    QPDF_DLL
+    std::string const& getName() const override;
+    QPDF_DLL
+    qpdf_offset_t tell() override;
+    QPDF_DLL
+    void seek(qpdf_offset_t offset, int whence) override;
+    QPDF_DLL
+    void rewind() override;
+    QPDF_DLL
+    size_t read(char* buffer, size_t length) override;
+    QPDF_DLL
+    void unreadCh(char ch) override;
+
+    // Return a view of the entire mapped file. The view remains valid for the lifetime of the
+    // input source.
+    QPDF_DLL
+    std::string_view view() const;
+
+  private:
+    QPDF_DLL_PRIVATE
+    void unmap();
+
+    std::string filename;
+    char const* data{nullptr};
+    qpdf_offset_t size{0};
+    qpdf_offset_t cur_offset{0};
+#ifdef _WIN32
+    void* mapping_handle{nullptr};
+#endif
+};
+
+#endif // QPDF_MMAPINPUTSOURCE_HH
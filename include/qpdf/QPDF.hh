@@ -268,6 +268,66 @@ class QPDF
     QPDF_DLL
     void setImmediateCopyFrom(bool);
 
+    // If true, processFile(char const* filename, ...) maps the input file into memory using
+    // MmapInputSource instead of reading it with FileInputSource. This avoids a system call and a
+    // copy through stdio buffers for every read and can be considerably faster for large files. If
+    // the file can't be mapped, processFile silently falls back to FileInputSource. The file must
+    // not be modified while the QPDF object is reading from it. This setting has no effect on the
+    // other process methods.
+    QPDF_DLL
+    void setUseMmap(bool);
+
+    // If true, objects read from the input file are allocated from a memory pool owned by this
+    // QPDF object rather than individually from the heap. This reduces memory use and time spent
+    // in the memory allocator when reading files with many objects. The pool is released when the
+    // QPDF object and all object handles that refer to objects allocated from it have been
+    // destroyed. Since memory from the pool is reused but never returned to the system until then,
+    // this is best suited to reading files rather than to long-running processes that create and
+    // discard large numbers of objects. The pool is not thread-safe, so object handles from this
+    // QPDF must only be used by a single thread. Call this before processing the file.
+    QPDF_DLL
+    void setUseObjectArena(bool);
+
+    // Operations that need every object in the file, such as getAllObjects or writing the file,
+    // resolve all objects in the xref table. By default, the object streams that contain
+    // compressed objects are decompressed one at a time as they are encountered. If this is set to
+    // a value other than 1, object streams are instead decompressed ahead of time on a pool of that
+    // many worker threads, with 0 meaning one thread per hardware thread. The objects themselves
+    // are still parsed on the calling thread. This can make processing large files with many
+    // object streams considerably faster on multi-core systems. It has no effect for encrypted
+    // files. If you have registered stream filters with registerStreamFilter, they must be safe to
+    // use from multiple threads when this is enabled.
+    QPDF_DLL
+    void setObjectStreamDecodeThreads(size_t);
+
+    // By default, every object that is read from the input file stays in memory for the life of
+    // the QPDF object. If this is set to a value other than 0, at most approximately that many of
+    // the objects read from the file after this call are kept in memory. When the limit is
+    // exceeded, the objects that were loaded least recently are evicted and are read from the file
+    // again the next time they are accessed. Object handles remain valid. This allows read-only
+    // operations on very large files, such as checking the file or writing it unchanged or as
+    // JSON, to run in bounded memory. Objects are evicted only by trimObjectCache, which is called
+    // automatically while resolving all objects, while writing the file and while writing JSON.
+    //
+    // This mode is intended for read-only processing. Objects that are replaced or swapped, and
+    // objects whose values, or the values of direct objects they contain, are modified through
+    // object handles, are never evicted. Since all objects in an object stream are loaded
+    // together, the limit should be larger than the number of objects in an object stream.
+    // Warnings about damaged objects may be repeated when they are read again.
+    QPDF_DLL
+    void setObjectCacheLimit(size_t max_objects);
+
+    // If true, QPDFWriter keeps a copy of the bytes it writes for each non-stream indirect object
+    // and reuses them when the same object is written again with compatible settings, such as when
+    // this QPDF is written several times or is linearized. Cached bytes are discarded when the
+    // object or any direct object in this QPDF is modified. Objects that contain direct objects
+    // that don't belong to this QPDF, such as objects created by QPDFObjectHandle::newArray and
+    // friends or by copying, are never cached since changes to them can't be detected. This uses
+    // additional memory roughly equal to the size of the objects in the output. Calling this
+    // method with false discards the cache.
+    QPDF_DLL
+    void setUnparsedObjectCache(bool);
+
     // Other public methods
 
     // Return the list of warnings that have been issued so far and clear the list.  This method may
@@ -662,6 +722,13 @@ class QPDF
     QPDF_DLL
     std::vector<QPDFObjectHandle> getAllObjects();
 
+    // If a limit has been set with setObjectCacheLimit, evict unmodified objects from memory until
+    // the limit is no longer exceeded. Handles to direct objects that were obtained from an evicted
+    // object are detached from this QPDF. This is called automatically at appropriate points, but
+    // may also be called explicitly, e.g. after processing each page of a file.
+    QPDF_DLL
+    void trimObjectCache();
+
     // Optimization support -- see doc/optimization.  Implemented in QPDF_optimization.cc
 
     // The object_stream_data map maps from a "compressed" object to the object stream that contains
@@ -739,6 +806,7 @@ class QPDF
     class ParseGuard;
     class Pipe;
     class JobSetter;
+    class UnparsedObject;
 
     // For testing only -- do not add to DLL
     static bool test_json_validators();
@@ -766,7 +834,11 @@ class QPDF
     void inParse(bool);
     void setTrailer(QPDFObjectHandle obj);
     void read_xref(qpdf_offset_t offset, bool in_stream_recovery = false);
-    bool resolveXRefTable();
+    void reserveTables();
+    void resolveAllObjects(bool trim);
+    bool resolveXRefTable(bool trim);
+    bool resolveObjectStreamsInParallel(bool trim);
+    std::function<std::shared_ptr<Buffer>()> objectStreamDecoder(int obj_stream_number);
     void reconstruct_xref(QPDFExc& e, bool found_startxref = true);
     bool parse_xrefFirst(std::string const& line, int& obj, int& num, int& bytes);
     bool read_xrefEntry(qpdf_offset_t& f1, int& f2, char& type);
@@ -819,6 +891,8 @@ class QPDF
         qpdf_offset_t end_before_space,
         qpdf_offset_t end_after_space,
         bool destroy = true);
+    void untrackEvictable(QPDFObjGen og);
+    void evictObject(QPDFObjGen og);
     static QPDFExc damagedPDF(
         InputSource& input,
         std::string const& object,
@@ -842,6 +916,11 @@ class QPDF
         bool will_retry);
     bool pipeForeignStreamData(
         std::shared_ptr<ForeignStreamData>, Pipeline*, bool suppress_warnings, bool will_retry);
+    // Return true if the stream data at offset can be copied unchanged from the input file with
+    // copyStreamData, which is the case if the file is not encrypted and contains all the data.
+    bool canCopyStreamData(qpdf_offset_t offset, size_t length);
+    // Does not call finish() on the pipeline
+    void copyStreamData(qpdf_offset_t offset, size_t length, Pipeline* pipeline);
     static bool pipeStreamData(
         std::shared_ptr<QPDF::EncryptionParameters> encp,
         std::shared_ptr<InputSource> file,
@@ -857,7 +936,6 @@ class QPDF
 
     // For QPDFWriter:
 
-    std::map<QPDFObjGen, QPDFXRefEntry> const& getXRefTableInternal();
     template <typename T>
     void optimize_internal(
         T const& object_stream_data,
@@ -892,6 +970,14 @@ class QPDF
     std::vector<QPDFObjGen> getCompressibleObjVector();
     std::vector<bool> getCompressibleObjSet();
 
+    // Copy the input file unchanged to pipeline in preparation for writing an incremental update and
+    // return the offset of its last cross-reference section. Does not call finish() on the pipeline.
+    qpdf_offset_t copyInputFile(Pipeline* pipeline);
+    // Get the objects that have been created or changed since the file was read in order of object
+    // number.
+    std::vector<QPDFObjGen> getChangedObjects();
+    bool changedSinceRead(QPDFObjGen og, QPDF& original);
+
     // methods to support page handling
 
     void getAllPagesInternal(
@@ -1012,6 +1098,7 @@ class QPDF
         std::function<int(QPDFObjectHandle&)> skip_stream_parameters);
     void filterCompressedObjects(std::map<int, int> const& object_stream_data);
     void filterCompressedObjects(QPDFWriter::ObjTable const& object_stream_data);
+    std::vector<std::set<QPDFObjGen>> getPageObjects();
 
     // JSON import
     void importJSON(std::shared_ptr<InputSource>, bool must_be_complete);
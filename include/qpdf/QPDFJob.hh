@@ -386,6 +386,27 @@ class QPDFJob
     QPDF_DLL
     void writeQPDF(QPDF& qpdf);
 
+    // The following two methods allow jobs to be chained so that the QPDF object created by one job
+    // is the input of the next one without writing and reading an intermediate file. See also
+    // chains of jobs in job lists (--job-list).
+
+    // Use the given QPDF object, usually one returned by another job's createQPDF(), as the input
+    // in place of an input file. It is treated as if its file had been given as the input file, so
+    // the file is used in messages and may be given to --pages as ".". Call this before
+    // initializing the job, which must not specify an input file. The QPDF object may refer to
+    // files that were opened by the job that created it, such as overlays or files given to
+    // --pages, so that job must not be destroyed until this one is done.
+    QPDF_DLL
+    void setInputQPDF(std::unique_ptr<QPDF>);
+
+    // Indicate that the QPDF object returned by createQPDF() will be passed to another job. Such a
+    // job doesn't need an output file and may not have an output file, options that only inspect
+    // the input, or options that control how output is written, such as --decrypt or --linearize,
+    // which must be given to the last job instead. Call createQPDF() rather than run() for such a
+    // job.
+    QPDF_DLL
+    void setChainedOutput(bool);
+
     // CHECK STATUS -- these methods provide information known after run() is called.
 
     QPDF_DLL
@@ -542,9 +563,15 @@ class QPDFJob
     void doListAttachments(QPDF& pdf);
     void doShowAttachment(QPDF& pdf);
 
+    // Job lists and server
+    void runJobList();
+    JSON runJobs(JSON const& list, size_t threads);
+    void serve();
+
     // Output generation
     void doSplitPages(QPDF& pdf);
     void setWriterOptions(QPDFWriter&);
+    bool hasWriterOptions() const;
     void setEncryptionOptions(QPDFWriter&);
     void maybeFixWritePassword(int R, std::string& password);
     void writeOutfile(QPDF& pdf);
@@ -594,6 +621,8 @@ class QPDFJob
         bool verbose{false};
         std::string password;
         bool linearize{false};
+        bool linearize_cache{false};
+        bool incremental_update{false};
         bool decrypt{false};
         bool remove_restrictions{false};
         int split_pages{0};
@@ -644,6 +673,14 @@ class QPDFJob
         bool object_stream_set{false};
         qpdf_object_stream_e object_stream_mode{qpdf_o_preserve};
         bool ignore_xref_streams{false};
+        bool use_mmap{false};
+        bool use_object_arena{false};
+        size_t threads{1};
+        size_t object_cache_limit{0};
+        size_t buffer_memory_limit{0};
+        size_t output_buffer_size{0};
+        bool sync_output{false};
+        bool deduplicate_objects{false};
         bool qdf_mode{false};
         bool preserve_unreferenced_objects{false};
         remove_unref_e remove_unreferenced_page_resources{re_auto};
@@ -652,6 +689,7 @@ class QPDFJob
         size_t keep_files_open_threshold{DEFAULT_KEEP_FILES_OPEN_THRESHOLD};
         bool newline_before_endstream{false};
         std::string linearize_pass1;
+        std::string write_statistics;
         bool coalesce_contents{false};
         bool flatten_annotations{false};
         int flatten_annotations_required{0};
@@ -712,6 +750,11 @@ class QPDFJob
         bool replace_input{false};
         bool check_is_encrypted{false};
         bool check_requires_password{false};
+        std::string job_list;
+        bool job_list_failed{false};
+        std::string serve_socket;
+        std::unique_ptr<QPDF> input_qpdf;
+        bool chained_output{false};
         std::string infilename;
         bool empty_input{false};
         std::string outfilename;
@@ -51,6 +51,7 @@ namespace qpdf::pl
 class QPDF;
 class Pl_Count;
 class Pl_MD5;
+class Pl_SpillBuffer;
 
 // This class implements a simple writer for saving QPDF objects to new PDF files.  See comments
 // through the header file for additional details.
@@ -103,6 +104,48 @@ class QPDFWriter
         std::function<void(int)> handler;
     };
 
+    // Information about where time was spent and what was done with stream data while writing. See
+    // setCollectStatistics.
+    struct Statistics
+    {
+        // Wall clock and CPU time in seconds spent in a phase of writing, not counting time spent
+        // in other phases entered from it. CPU time is for the whole process, so it includes time
+        // spent by worker threads while the phase was active.
+        struct Phase
+        {
+            double wall_time{0.0};
+            double cpu_time{0.0};
+        };
+
+        // Streams written, grouped by the filters of the original stream data. bytes_in is the
+        // length of the original data, and bytes_out is the length of the data that was written.
+        struct Filter
+        {
+            size_t streams{0};
+            size_t bytes_in{0};
+            size_t bytes_out{0};
+        };
+
+        std::map<std::string, Phase> phases;
+        std::map<std::string, Filter> filters;
+        // Indirect objects written, including objects in object streams
+        size_t objects{0};
+        size_t object_streams{0};
+        // Streams that were decoded and compressed again
+        size_t streams_recompressed{0};
+        // Streams that were decoded and written without compression
+        size_t streams_decoded{0};
+        // Streams whose data was written with its original filters
+        size_t streams_passed_through{0};
+        // Objects that were replaced by an identical object by setDeduplicateObjects
+        size_t objects_deduplicated{0};
+        size_t bytes_written{0};
+
+        // Return the statistics as a JSON object.
+        QPDF_DLL
+        JSON getJSON() const;
+    };
+
     // Setting Output.  Output may be set only one time.  If you don't use the filename version of
     // the QPDFWriter constructor, you must call exactly one of these methods.
 
@@ -212,6 +255,15 @@ class QPDFWriter
     QPDF_DLL
     void setRecompressFlate(bool);
 
+    // Compress stream data on a pool of n worker threads, with 0 meaning one thread per hardware
+    // thread. The default is 1, which means that all work is done on the calling thread. When
+    // enabled, the data of streams that are about to be written is retrieved and filtered ahead of
+    // time on the calling thread, and deflated on the worker threads while earlier objects are
+    // being written. The output is identical regardless of the number of threads. This only
+    // applies to non-linearized files.
+    QPDF_DLL
+    void setCompressionThreads(size_t n);
+
     // Set value of content stream normalization.  The default is "false".  If true, we attempt to
     // normalize newlines inside of content streams.  Some constructs such as inline images may
     // thwart our efforts.  There may be some cases where this can damage the content stream.  This
@@ -405,6 +457,56 @@ class QPDFWriter
     QPDF_DLL
     void setLinearizationPass1Filename(std::string const&);
 
+    // When linearizing, keep the bytes of each object written in the first pass in memory and
+    // write them again in the second pass rather than unparsing and compressing every object
+    // twice. This makes linearization considerably faster at the cost of holding most of the
+    // output file in memory. The output is the same either way. The default is "false".
+    QPDF_DLL
+    void setLinearizationObjectCache(bool);
+
+    // Limit the amount of memory used to hold the data of a single stream or object stream while it
+    // is being written. The writer has to keep the filtered and compressed data of a stream until it
+    // knows its length. Data that exceeds the limit is moved to a temporary file instead. Streams
+    // whose data exceeds the limit are not compressed on worker threads. The default is 0, which
+    // means there is no limit. This does not apply to the data kept by
+    // setLinearizationObjectCache or to output written to memory.
+    QPDF_DLL
+    void setBufferMemoryLimit(size_t bytes);
+
+    // Collect up to the given number of bytes of output before passing it to the output file or
+    // pipeline instead of passing on each of the many small pieces that make up an object as it is
+    // written. This reduces the number of calls through the output pipeline and of system calls
+    // when writing files with many small objects. Sizes of 1 MB to 8 MB work well for large
+    // files. The default is 0, which passes output on as it is written.
+    QPDF_DLL
+    void setOutputBufferSize(size_t bytes);
+
+    // If true, when writing to a file given by name, flush the file and have the operating system
+    // write it to storage before write() returns. The default is "false".
+    QPDF_DLL
+    void setSyncOutput(bool);
+
+    // Before writing, find indirect objects that are identical to other objects, such as fonts,
+    // color profiles, or images that were copied from several similar files, and change all
+    // references to each of them to refer to a single copy. Streams are compared by their
+    // dictionaries and raw data. Page objects, annotations, and objects that are part of a tree
+    // such as the outline or structure hierarchy are never merged. This modifies the QPDF object.
+    // Objects that are no longer referenced are not written unless unreferenced objects are
+    // preserved. This has no effect on incremental updates. The default is "false".
+    QPDF_DLL
+    void setDeduplicateObjects(bool);
+
+    // Write an incremental update: copy the input file unchanged and append only the objects that
+    // were created or changed since it was read, followed by a cross-reference section whose trailer
+    // points to the original one with /Prev. Objects keep their original numbers. This preserves
+    // the original bytes of the file, which is required to keep digital signatures valid, and is
+    // much faster than rewriting a large file to which few changes were made. The input file must
+    // not be encrypted, and incremental updates can't be combined with linearization, QDF mode,
+    // PCLm, or encryption. Object stream settings and the PDF version don't apply since the
+    // original file is kept. The default is "false".
+    QPDF_DLL
+    void setIncrementalUpdate(bool);
+
     // Create PCLm output. This is only useful for clients that know how to create PCLm files. If a
     // file is structured exactly as PCLm requires, this call will tell QPDFWriter to write the PCLm
     // header, create certain unreferenced streams required by the standard, and write the objects
@@ -418,6 +520,16 @@ class QPDFWriter
     QPDF_DLL
     void registerProgressReporter(std::shared_ptr<ProgressReporter>);
 
+    // Collect statistics while writing, which can be retrieved with getStatistics after write()
+    // returns. This is intended for finding out where time is spent when writing files and has a
+    // small cost. The default is "false".
+    QPDF_DLL
+    void setCollectStatistics(bool);
+
+    // Return the statistics collected by write() if setCollectStatistics(true) was called.
+    QPDF_DLL
+    Statistics const& getStatistics() const;
+
     // Return the PDF version that will be written into the header. Calling this method does all the
     // preparation for writing, so it is an error to call any methods that may cause a change to the
     // version. Adding new objects to the original file after calling this may also cause problems.
@@ -478,6 +590,23 @@ class QPDFWriter
         unsigned long stack_id{0};
     };
 
+    // When statistics are being collected, time spent while a PhaseTimer exists is attributed to
+    // its phase until the PhaseTimer goes out of scope or another PhaseTimer is created.
+    class PhaseTimer
+    {
+      public:
+        PhaseTimer(QPDFWriter* qw, char const* phase);
+        ~PhaseTimer();
+
+      private:
+        QPDFWriter* qw{nullptr};
+        char const* previous{nullptr};
+    };
+    void switchPhase(char const* phase);
+    void syncOutputFile();
+    char const* streamDataPhase() const;
+    void countStream(QPDFObjectHandle stream, int flags, bool compress);
+
     unsigned int bytesNeeded(long long n);
     void writeBinary(unsigned long long val, unsigned int bytes);
     void writeString(std::string_view str);
@@ -487,7 +616,16 @@ class QPDFWriter
     void assignCompressedObjectNumbers(QPDFObjGen og);
     void enqueueObject(QPDFObjectHandle object);
     void writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, int first_obj);
+    qpdf_offset_t unparseObjectStream(int old_id, Pl_SpillBuffer& stream_data);
     void writeObjectStream(QPDFObjectHandle object);
+    void
+    writeObjectStream(QPDFObjectHandle object, qpdf_offset_t first, Pl_SpillBuffer& stream_data);
+    void writeObjectStreamData(
+        QPDFObjectHandle object, qpdf_offset_t first, Pl_SpillBuffer& stream_data);
+    void writeObjectWithThreads(QPDFObjectHandle object);
+    void flushObjectStream();
+    void writeObjectToBuffer(QPDFObjectHandle object, std::string& buffer, std::vector<int>& ids);
+    void rebaseObjectOffsets(std::vector<int> const& ids, qpdf_offset_t delta);
     void writeObject(QPDFObjectHandle object, int object_stream_index = -1);
     void writeTrailer(
         trailer_e which, int size, bool xref_stream, qpdf_offset_t prev, int linearization_pass);
@@ -495,7 +633,10 @@ class QPDFWriter
         QPDFObjectHandle stream,
         bool& compress_stream,
         bool& is_metadata,
-        std::string* stream_data);
+        Pl_SpillBuffer* stream_data,
+        bool defer_compression = false,
+        bool* copy_raw = nullptr);
+    void prepareStreams();
     void unparseObject(
         QPDFObjectHandle object,
         int level,
@@ -504,6 +645,7 @@ class QPDFWriter
         size_t stream_length = 0,
         bool compress = false);
     void unparseChild(QPDFObjectHandle child, int level, int flags);
+    void unparseObjectCached(QPDFObjectHandle object, int flags);
     void initializeSpecialStreams();
     void preserveObjectStreams();
     void generateObjectStreams();
@@ -545,14 +687,18 @@ class QPDFWriter
         std::string const& user_password,
         std::string const& encryption_key);
     void setDataKey(int objid);
-    int openObject(int objid = 0);
+    int openObject(int objid = 0, int gen = 0);
     void closeObject(int objid);
     QPDFObjectHandle getTrimmedTrailer();
     void prepareFileForWrite();
+    void deduplicateObjects();
     void enqueueObjectsStandard();
     void enqueueObjectsPCLm();
     void indicateProgress(bool decrement, bool finished);
     void writeStandard();
+    void writeIncremental();
+    qpdf_offset_t writeIncrementalXRef(
+        std::vector<QPDFObjGen> const& objects, qpdf_offset_t prev, bool xref_stream);
     void writeLinearized();
     void enqueuePart(std::vector<QPDFObjectHandle>& part);
     void writeEncryptionDictionary();
@@ -603,6 +749,7 @@ class QPDFWriter
     // is popped.
     Pipeline* pushPipeline(Pipeline*);
     void activatePipelineStack(PipelinePopper& pp, std::string& str);
+    void activatePipelineStack(PipelinePopper& pp, Pl_SpillBuffer& buffer);
     void activatePipelineStack(PipelinePopper& pp, std::unique_ptr<qpdf::pl::Link> link);
     void activatePipelineStack(
         PipelinePopper& pp,
@@ -10,16 +10,19 @@ QPDF_DLL Config* check();
 QPDF_DLL Config* checkLinearization();
 QPDF_DLL Config* coalesceContents();
 QPDF_DLL Config* decrypt();
+QPDF_DLL Config* deduplicateObjects();
 QPDF_DLL Config* deterministicId();
 QPDF_DLL Config* externalizeInlineImages();
 QPDF_DLL Config* filteredStreamData();
 QPDF_DLL Config* flattenRotation();
 QPDF_DLL Config* generateAppearances();
 QPDF_DLL Config* ignoreXrefStreams();
+QPDF_DLL Config* incrementalUpdate();
 QPDF_DLL Config* isEncrypted();
 QPDF_DLL Config* jsonInput();
 QPDF_DLL Config* keepInlineImages();
 QPDF_DLL Config* linearize();
+QPDF_DLL Config* linearizeCache();
 QPDF_DLL Config* listAttachments();
 QPDF_DLL Config* newlineBeforeEndstream();
 QPDF_DLL Config* noOriginalObjectIds();
@@ -49,10 +52,14 @@ QPDF_DLL Config* staticAesIv();
 QPDF_DLL Config* staticId();
 QPDF_DLL Config* suppressPasswordRecovery();
 QPDF_DLL Config* suppressRecovery();
+QPDF_DLL Config* syncOutput();
 QPDF_DLL Config* testJsonSchema();
+QPDF_DLL Config* useMmap();
+QPDF_DLL Config* useObjectArena();
 QPDF_DLL Config* verbose();
 QPDF_DLL Config* warningExit0();
 QPDF_DLL Config* withImages();
+QPDF_DLL Config* bufferMemoryLimit(std::string const& parameter);
 QPDF_DLL Config* compressionLevel(std::string const& parameter);
 QPDF_DLL Config* jpegQuality(std::string const& parameter);
 QPDF_DLL Config* copyEncryption(std::string const& parameter);
@@ -60,21 +67,27 @@ QPDF_DLL Config* encryptionFilePassword(std::string const& parameter);
 QPDF_DLL Config* forceVersion(std::string const& parameter);
 QPDF_DLL Config* iiMinBytes(std::string const& parameter);
 QPDF_DLL Config* jobJsonFile(std::string const& parameter);
+QPDF_DLL Config* jobList(std::string const& parameter);
 QPDF_DLL Config* jsonObject(std::string const& parameter);
 QPDF_DLL Config* keepFilesOpenThreshold(std::string const& parameter);
 QPDF_DLL Config* linearizePass1(std::string const& parameter);
 QPDF_DLL Config* minVersion(std::string const& parameter);
+QPDF_DLL Config* objectCacheLimit(std::string const& parameter);
 QPDF_DLL Config* oiMinArea(std::string const& parameter);
 QPDF_DLL Config* oiMinHeight(std::string const& parameter);
 QPDF_DLL Config* oiMinWidth(std::string const& parameter);
+QPDF_DLL Config* outputBufferSize(std::string const& parameter);
 QPDF_DLL Config* password(std::string const& parameter);
 QPDF_DLL Config* passwordFile(std::string const& parameter);
 QPDF_DLL Config* removeAttachment(std::string const& parameter);
 QPDF_DLL Config* rotate(std::string const& parameter);
+QPDF_DLL Config* serve(std::string const& parameter);
 QPDF_DLL Config* showAttachment(std::string const& parameter);
 QPDF_DLL Config* showObject(std::string const& parameter);
 QPDF_DLL Config* jsonStreamPrefix(std::string const& parameter);
+QPDF_DLL Config* threads(std::string const& parameter);
 QPDF_DLL Config* updateFromJson(std::string const& parameter);
+QPDF_DLL Config* writeStatistics(std::string const& parameter);
 QPDF_DLL Config* collate(std::string const& parameter);
 QPDF_DLL Config* collate();
 QPDF_DLL Config* splitPages(std::string const& parameter);
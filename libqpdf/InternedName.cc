@@ -0,0 +1,78 @@
+#include <qpdf/InternedName.hh>
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    // The table is divided into shards, each with its own mutex, to reduce contention when several
+    // threads are parsing files at the same time.
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, void*> entries;
+    };
+
+    constexpr size_t n_shards = 16;
+
+    std::array<Shard, n_shards>&
+    shards()
+    {
+        // The table is intentionally never destroyed, so that InternedNames held by static objects
+        // can be safely released during program termination.
+        static auto* table = new std::array<Shard, n_shards>;
+        return *table;
+    }
+} // namespace
+
+std::string const InternedName::empty;
+
+InternedName::Entry*
+InternedName::intern(std::string_view value)
+{
+    auto hash = std::hash<std::string_view>()(value);
+    auto& shard = shards()[hash % n_shards];
+    std::lock_guard lock(shard.mutex);
+    if (auto it = shard.entries.find(value); it != shard.entries.end()) {
+        auto entry = static_cast<Entry*>(it->second);
+        entry->refs.fetch_add(1, std::memory_order_relaxed);
+        return entry;
+    }
+    auto entry = new Entry(value, hash);
+    // The key refers to the entry's own copy of the value.
+    shard.entries.emplace(entry->value, entry);
+    return entry;
+}
+
+void
+InternedName::release(Entry* entry)
+{
+    // Decrement without locking unless this may be the last reference. New references to an entry
+    // are only created by copying an existing reference or by intern, which holds the shard's
+    // mutex, so once the count drops to zero while the mutex is held the entry can't be revived.
+    auto refs = entry->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (entry->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    auto& shard = shards()[entry->hash % n_shards];
+    std::lock_guard lock(shard.mutex);
+    if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        shard.entries.erase(entry->value);
+        delete entry;
+    }
+}
+
+size_t
+InternedName::table_size()
+{
+    size_t result = 0;
+    for (auto& shard: shards()) {
+        std::lock_guard lock(shard.mutex);
+        result += shard.entries.size();
+    }
+    return result;
+}
@@ -0,0 +1,204 @@
+#include <qpdf/MmapInputSource.hh>
+
+#include <qpdf/QIntC.hh>
+#include <qpdf/QUtil.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN
+# include <io.h>
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+MmapInputSource::MmapInputSource(char const* filename) :
+    filename(filename)
+{
+    // Open with safe_fopen so that we get the same filename handling (including UTF-8 filenames on
+    // Windows) and the same error messages as FileInputSource. The mapping stays valid after the
+    // file has been closed.
+    QUtil::FileCloser fc(QUtil::safe_fopen(filename, "rb"));
+#ifdef _WIN32
+    auto fh = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fc.f)));
+    LARGE_INTEGER file_size;
+    if (fh == INVALID_HANDLE_VALUE || !GetFileSizeEx(fh, &file_size)) {
+        QUtil::throw_system_error(this->filename + ": unable to determine file size");
+    }
+    if (QIntC::to_ulonglong(file_size.QuadPart) > std::numeric_limits<size_t>::max()) {
+        throw std::runtime_error(this->filename + ": file is too large to map into memory");
+    }
+    this->size = file_size.QuadPart;
+    if (this->size == 0) {
+        return;
+    }
+    this->mapping_handle = CreateFileMappingW(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->mapping_handle == nullptr) {
+        QUtil::throw_system_error(this->filename + ": CreateFileMapping");
+    }
+    this->data = static_cast<char const*>(MapViewOfFile(
+        static_cast<HANDLE>(this->mapping_handle), FILE_MAP_READ, 0, 0, QIntC::to_size(size)));
+    if (this->data == nullptr) {
+        CloseHandle(static_cast<HANDLE>(this->mapping_handle));
+        this->mapping_handle = nullptr;
+        QUtil::throw_system_error(this->filename + ": MapViewOfFile");
+    }
+#else
+    int fd = fileno(fc.f);
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        QUtil::throw_system_error(this->filename + ": fstat");
+    }
+    if (!S_ISREG(st.st_mode)) {
+        throw std::runtime_error(this->filename + ": only regular files can be mapped into memory");
+    }
+    if (QIntC::to_ulonglong(st.st_size) > std::numeric_limits<size_t>::max()) {
+        throw std::runtime_error(this->filename + ": file is too large to map into memory");
+    }
+    this->size = QIntC::to_offset(st.st_size);
+    if (this->size == 0) {
+        // A zero-length mapping is not allowed. There is nothing to read anyway.
+        return;
+    }
+    void* p = mmap(nullptr, QIntC::to_size(this->size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        QUtil::throw_system_error(this->filename + ": mmap");
+    }
+    this->data = static_cast<char const*>(p);
+#endif
+}
+
+MmapInputSource::~MmapInputSource()
+{
+    // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
+    unmap();
+}
+
+void
+MmapInputSource::unmap()
+{
+    if (this->data == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(this->data);
+    CloseHandle(static_cast<HANDLE>(this->mapping_handle));
+    this->mapping_handle = nullptr;
+#else
+    munmap(const_cast<char*>(this->data), QIntC::to_size(this->size));
+#endif
+    this->data = nullptr;
+}
+
+std::string_view
+MmapInputSource::view() const
+{
+    return {this->data, QIntC::to_size(this->size)};
+}
+
+qpdf_offset_t
+MmapInputSource::findAndSkipNextEOL()
+{
+    if (this->cur_offset < 0) {
+        throw std::logic_error("INTERNAL ERROR: MmapInputSource offset < 0");
+    }
+    if (this->cur_offset >= this->size) {
+        this->last_offset = this->size;
+        this->cur_offset = this->size;
+        return this->size;
+    }
+
+    char const* end = this->data + this->size;
+    char const* p = this->data + this->cur_offset;
+    while (p < end && !(*p == '\r' || *p == '\n')) {
+        ++p;
+    }
+    if (p == end) {
+        this->cur_offset = this->size;
+        return this->size;
+    }
+    qpdf_offset_t result = p - this->data;
+    ++p;
+    while (p < end && (*p == '\r' || *p == '\n')) {
+        ++p;
+    }
+    this->cur_offset = p - this->data;
+    return result;
+}
+
+std::string const&
+MmapInputSource::getName() const
+{
+    return this->filename;
+}
+
+qpdf_offset_t
+MmapInputSource::tell()
+{
+    return this->cur_offset;
+}
+
+void
+MmapInputSource::seek(qpdf_offset_t offset, int whence)
+{
+    switch (whence) {
+    case SEEK_SET:
+        this->cur_offset = offset;
+        break;
+
+    case SEEK_END:
+        QIntC::range_check(this->size, offset);
+        this->cur_offset = this->size + offset;
+        break;
+
+    case SEEK_CUR:
+        QIntC::range_check(this->cur_offset, offset);
+        this->cur_offset += offset;
+        break;
+
+    default:
+        throw std::logic_error("INTERNAL ERROR: invalid argument to MmapInputSource::seek");
+        break;
+    }
+
+    if (this->cur_offset < 0) {
+        throw std::runtime_error(this->filename + ": seek before beginning of file");
+    }
+}
+
+void
+MmapInputSource::rewind()
+{
+    this->cur_offset = 0;
+}
+
+size_t
+MmapInputSource::read(char* buffer, size_t length)
+{
+    if (this->cur_offset < 0) {
+        throw std::logic_error("INTERNAL ERROR: MmapInputSource offset < 0");
+    }
+    if (this->cur_offset >= this->size) {
+        this->last_offset = this->size;
+        return 0;
+    }
+
+    this->last_offset = this->cur_offset;
+    size_t len = std::min(QIntC::to_size(this->size - this->cur_offset), length);
+    memcpy(buffer, this->data + this->cur_offset, len);
+    this->cur_offset += QIntC::to_offset(len);
+    return len;
+}
+
+void
+MmapInputSource::unreadCh(char)
+{
+    if (this->cur_offset > 0) {
+        --this->cur_offset;
+    }
+}
@@ -0,0 +1,122 @@
+#include <qpdf/qpdf-config.h> // include first for large file support
+
+#include <qpdf/Pl_SpillBuffer.hh>
+
+#include <qpdf/QUtil.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+Pl_SpillBuffer::Pl_SpillBuffer(char const* identifier, size_t memory_limit) :
+    Pipeline(identifier, nullptr),
+    memory_limit(memory_limit)
+{
+}
+
+Pl_SpillBuffer::~Pl_SpillBuffer()
+{
+    if (file) {
+        fclose(file);
+    }
+}
+
+void
+Pl_SpillBuffer::write(unsigned char const* buf, size_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    last_char = static_cast<char>(buf[len - 1]);
+    if (!file && memory_limit > 0 && data.size() + len > memory_limit) {
+        spill();
+    }
+    if (!file) {
+        data.append(reinterpret_cast<char const*>(buf), len);
+        return;
+    }
+    if (fwrite(buf, 1, len, file) != len) {
+        QUtil::throw_system_error(identifier + ": Pl_SpillBuffer::write");
+    }
+    file_size += len;
+}
+
+void
+Pl_SpillBuffer::finish()
+{
+}
+
+void
+Pl_SpillBuffer::spill()
+{
+    file = tmpfile();
+    if (!file) {
+        QUtil::throw_system_error(identifier + ": unable to create temporary file");
+    }
+    file_size = 0;
+    if (!data.empty()) {
+        if (fwrite(data.data(), 1, data.size(), file) != data.size()) {
+            QUtil::throw_system_error(identifier + ": Pl_SpillBuffer::write");
+        }
+        file_size = data.size();
+    }
+    data.clear();
+    data.shrink_to_fit();
+}
+
+void
+Pl_SpillBuffer::assign(std::string&& str)
+{
+    clear();
+    data = std::move(str);
+    last_char = data.empty() ? '\0' : data.back();
+}
+
+void
+Pl_SpillBuffer::clear()
+{
+    if (file) {
+        fclose(file);
+        file = nullptr;
+        file_size = 0;
+    }
+    data.clear();
+    last_char = '\0';
+}
+
+void
+Pl_SpillBuffer::writeTo(Pipeline& p)
+{
+    if (!file) {
+        p.writeString(data);
+        return;
+    }
+    if (fflush(file) != 0 || QUtil::seek(file, 0, SEEK_SET) != 0) {
+        QUtil::throw_system_error(identifier + ": Pl_SpillBuffer::writeTo");
+    }
+    unsigned char buf[65536];
+    size_t left = file_size;
+    while (left > 0) {
+        size_t len = fread(buf, 1, std::min(left, sizeof(buf)), file);
+        if (len == 0) {
+            QUtil::throw_system_error(identifier + ": Pl_SpillBuffer::writeTo");
+        }
+        p.write(buf, len);
+        left -= len;
+    }
+    // Subsequent writes append to the end of the file.
+    if (QUtil::seek(file, 0, SEEK_END) != 0) {
+        QUtil::throw_system_error(identifier + ": Pl_SpillBuffer::writeTo");
+    }
+}
+
+std::string
+Pl_SpillBuffer::getString()
+{
+    if (file) {
+        throw std::logic_error(identifier + ": Pl_SpillBuffer::getString called after spilling");
+    }
+    std::string result;
+    result.swap(data);
+    last_char = '\0';
+    return result;
+}
@@ -2,6 +2,7 @@
 
 #include <qpdf/QPDF_private.hh>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstring>
@@ -14,6 +15,7 @@
 #include <qpdf/BufferInputSource.hh>
 #include <qpdf/FileInputSource.hh>
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/QPDFExc.hh>
@@ -244,8 +246,19 @@ QPDF::create()
 void
 QPDF::processFile(char const* filename, char const* password)
 {
-    auto* fi = new FileInputSource(filename);
-    processInputSource(std::shared_ptr<InputSource>(fi), password);
+    std::shared_ptr<InputSource> is;
+    if (m->use_mmap) {
+        try {
+            is = std::make_shared<MmapInputSource>(filename);
+        } catch (std::exception&) {
+            // Fall back to ordinary file I/O. If the file can't be opened at all, FileInputSource
+            // will throw the usual exception.
+        }
+    }
+    if (!is) {
+        is = std::make_shared<FileInputSource>(filename);
+    }
+    processInputSource(is, password);
 }
 
 void
@@ -348,6 +361,49 @@ QPDF::setImmediateCopyFrom(bool val)
     m->immediate_copy_from = val;
 }
 
+void
+QPDF::setUseMmap(bool val)
+{
+    m->use_mmap = val;
+}
+
+void
+QPDF::setUseObjectArena(bool val)
+{
+    if (val) {
+        m->object_arena.create();
+    } else {
+        m->object_arena.reset();
+    }
+}
+
+void
+QPDF::setObjectStreamDecodeThreads(size_t n)
+{
+    m->object_stream_decode_threads = n;
+}
+
+void
+QPDF::setObjectCacheLimit(size_t max_objects)
+{
+    m->object_cache_limit = max_objects;
+    if (max_objects == 0) {
+        // Keep everything that has been loaded so far.
+        m->evictable_objects.clear();
+        m->evictable_positions.clear();
+        m->direct_object_owners.clear();
+    }
+}
+
+void
+QPDF::setUnparsedObjectCache(bool val)
+{
+    m->unparsed_object_cache = val;
+    if (!val) {
+        m->unparsed_objects.clear();
+    }
+}
+
 std::vector<QPDFExc>
 QPDF::getWarnings()
 {
@@ -829,18 +885,11 @@ QPDF::getRoot()
 
 std::map<QPDFObjGen, QPDFXRefEntry>
 QPDF::getXRefTable()
-{
-    return getXRefTableInternal();
-}
-
-std::map<QPDFObjGen, QPDFXRefEntry> const&
-QPDF::getXRefTableInternal()
 {
     if (!m->parsed) {
         throw std::logic_error("QPDF::getXRefTable called before parsing.");
     }
-
-    return m->xref_table;
+    return {m->xref_table.begin(), m->xref_table.end()};
 }
 
 bool
@@ -935,6 +984,33 @@ QPDF::pipeStreamData(
         will_retry);
 }
 
+bool
+QPDF::canCopyStreamData(qpdf_offset_t offset, size_t length)
+{
+    if (m->encp->encrypted || offset <= 0) {
+        return false;
+    }
+    m->file->seek(0, SEEK_END);
+    return m->file->tell() - offset >= toO(length);
+}
+
+void
+QPDF::copyStreamData(qpdf_offset_t offset, size_t length, Pipeline* pipeline)
+{
+    // Copy the data in large chunks so that large streams don't have to be held in memory.
+    static constexpr size_t max_chunk = 1 << 20;
+    std::string buf(std::min(length, max_chunk), '\0');
+    m->file->seek(offset, SEEK_SET);
+    while (length > 0) {
+        size_t len = m->file->read(buf.data(), std::min(length, buf.size()));
+        if (len == 0) {
+            throw damagedPDF("", m->file->getLastOffset(), "unexpected EOF reading stream data");
+        }
+        pipeline->write(reinterpret_cast<unsigned char const*>(buf.data()), len);
+        length -= len;
+    }
+}
+
 bool
 QPDF::pipeForeignStreamData(
     std::shared_ptr<ForeignStreamData> foreign,
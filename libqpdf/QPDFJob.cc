@@ -1,11 +1,19 @@
 #include <qpdf/QPDFJob.hh>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
 
 #include <qpdf/ClosedFileInputSource.hh>
 #include <qpdf/FileInputSource.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_DCT.hh>
 #include <qpdf/Pl_Discard.hh>
@@ -29,6 +37,7 @@
 #include <qpdf/QPDF_private.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
+#include <qpdf/ThreadPool.hh>
 #include <qpdf/Util.hh>
 
 #include <qpdf/auto_job_schema.hh> // JOB_SCHEMA_DATA
@@ -104,6 +113,68 @@ namespace
         std::string prefix;
         std::string filename;
     };
+
+    // Writes ranges of pages of a file straight from the file's objects for --split-pages. The
+    // objects used by each page are found once up front, so resources that are shared by many pages
+    // are not traversed and copied again for each output file. While a range is selected, the file
+    // has a catalog and trailer that contain only the pages in the range, and references to any
+    // other pages are null, as they are when the pages are copied to a new file.
+    class PageSplitter
+    {
+      public:
+        PageSplitter(QPDF& pdf, std::vector<std::set<QPDFObjGen>> const& page_objects);
+        ~PageSplitter();
+
+        // Return false if the pages can't be written this way, in which case the pages must be
+        // copied to a new file.
+        bool
+        usable() const
+        {
+            return usable_;
+        }
+
+        // Select pages first through last, numbered from 0, until restore is called. QPDF's list
+        // of pages is brought up to date when the PageSplitter is destroyed.
+        void select(size_t first, size_t last, QPDFObjectHandle page_labels);
+        void restore();
+
+      private:
+        // A reference to a page or pages tree node within an object used by a page. The path leads
+        // from the indirect object holder to the reference through dictionary keys and array
+        // indices.
+        struct Link
+        {
+            QPDFObjGen holder;
+            std::vector<std::variant<std::string, int>> path;
+            QPDFObjGen target;
+        };
+
+        void findLinks(QPDFObjectHandle oh, Link& link, bool is_page);
+        void setLink(Link const& link, QPDFObjectHandle value);
+
+        QPDF& pdf;
+        bool usable_{true};
+        std::vector<QPDFObjectHandle> pages;
+        std::map<QPDFObjGen, size_t> page_numbers;
+        std::vector<Link> links;
+        std::vector<std::vector<size_t>> page_links;
+        bool selected{false};
+        // The catalog, pages tree node and indirect nulls of the selected range are added to the
+        // file when they are first needed and reused for every range, so the file doesn't grow.
+        QPDFObjectHandle root;
+        QPDFObjectHandle pages_node;
+        std::vector<QPDFObjectHandle> indirect_nulls;
+
+        // State while a range is selected
+        size_t first{0};
+        size_t last{0};
+        std::vector<size_t> nulled_links;
+        std::vector<QPDFObjectHandle> parents;
+        std::map<std::string, QPDFObjectHandle> trailer;
+    };
+
+    // Serializes output to the logger while split pages are written by worker threads.
+    std::mutex output_mutex;
 } // namespace
 
 ImageOptimizer::ImageOptimizer(
@@ -292,9 +363,213 @@ QPDFPageData::QPDFPageData(QPDFPageData const& other, int page) :
 void
 ProgressReporter::reportProgress(int percentage)
 {
+    std::lock_guard lock(output_mutex);
     p << prefix << ": " << filename << ": write progress: " << percentage << "%\n";
 }
 
+PageSplitter::PageSplitter(QPDF& pdf, std::vector<std::set<QPDFObjGen>> const& page_objects) :
+    pdf(pdf)
+{
+    pages = pdf.getAllPages();
+    for (size_t i = 0; i < pages.size(); ++i) {
+        page_numbers[pages.at(i).getObjGen()] = i;
+    }
+    auto root_og = pdf.getRoot().getObjGen();
+    // Objects are often used by many pages, so find the links in each object only once.
+    std::map<QPDFObjGen, std::vector<size_t>> object_links;
+    page_links.resize(pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        for (auto const& og: page_objects.at(i)) {
+            auto [iter, inserted] = object_links.try_emplace(og);
+            if (inserted) {
+                auto oh = pdf.getObject(og);
+                if (og == root_og || oh.isDictionaryOfType("/Catalog")) {
+                    // The page refers to things that aren't part of any page.
+                    usable_ = false;
+                    return;
+                }
+                if (oh.isDictionaryOfType("/Pages")) {
+                    // References to pages tree nodes are always null, so their contents are never
+                    // written.
+                    continue;
+                }
+                auto start = links.size();
+                Link link{og, {}, {}};
+                findLinks(oh.isStream() ? oh.getDict() : oh, link, page_numbers.contains(og));
+                for (auto j = start; j < links.size(); ++j) {
+                    iter->second.push_back(j);
+                }
+            }
+            auto& these_links = page_links.at(i);
+            these_links.insert(these_links.end(), iter->second.begin(), iter->second.end());
+        }
+    }
+}
+
+PageSplitter::~PageSplitter()
+{
+    if (selected) {
+        try {
+            pdf.updateAllPagesCache();
+        } catch (std::exception&) {
+            // The pages were found before the first range was selected, so this can't happen.
+        }
+    }
+}
+
+void
+PageSplitter::findLinks(QPDFObjectHandle oh, Link& link, bool is_page)
+{
+    auto check = [this, &link](QPDFObjectHandle item) {
+        if (item.isIndirect()) {
+            if (page_numbers.contains(item.getObjGen()) || item.isDictionaryOfType("/Page") ||
+                item.isDictionaryOfType("/Pages")) {
+                links.push_back(link);
+                links.back().target = item.getObjGen();
+            }
+        } else {
+            findLinks(item, link, false);
+        }
+    };
+    if (oh.isArray()) {
+        int i = 0;
+        for (auto const& item: oh.as_array()) {
+            link.path.emplace_back(i++);
+            check(item);
+            link.path.pop_back();
+        }
+    } else if (oh.isDictionary()) {
+        for (auto const& [key, value]: oh.as_dictionary()) {
+            if (value.null() || (is_page && key == "/Parent")) {
+                // The page's /Parent is replaced when it is selected.
+                continue;
+            }
+            link.path.emplace_back(key);
+            check(value);
+            link.path.pop_back();
+        }
+    }
+}
+
+void
+PageSplitter::setLink(Link const& link, QPDFObjectHandle value)
+{
+    auto container = pdf.getObject(link.holder);
+    if (container.isStream()) {
+        container = container.getDict();
+    }
+    for (size_t i = 0; i + 1 < link.path.size(); ++i) {
+        if (auto key = std::get_if<std::string>(&link.path.at(i))) {
+            container = container.getKey(*key);
+        } else {
+            container = container.getArrayItem(std::get<int>(link.path.at(i)));
+        }
+    }
+    if (auto key = std::get_if<std::string>(&link.path.back())) {
+        container.replaceKey(*key, value);
+    } else {
+        container.setArrayItem(std::get<int>(link.path.back()), value);
+    }
+}
+
+void
+PageSplitter::select(size_t first_page, size_t last_page, QPDFObjectHandle page_labels)
+{
+    first = first_page;
+    last = last_page;
+    auto in_range = [this](QPDFObjGen og) {
+        auto iter = page_numbers.find(og);
+        return iter != page_numbers.end() && iter->second >= first && iter->second <= last;
+    };
+
+    // Match what copying the pages does: references to other pages become references to an
+    // indirect null, and references to pages tree nodes become null.
+    std::set<size_t> seen;
+    std::map<QPDFObjGen, QPDFObjectHandle> nulls;
+    size_t n_indirect_nulls = 0;
+    for (size_t i = first; i <= last; ++i) {
+        for (auto j: page_links.at(i)) {
+            auto target = links.at(j).target;
+            if (in_range(target) || !seen.insert(j).second) {
+                continue;
+            }
+            QTC::TC("qpdf", "QPDFJob split pages null link");
+            auto& null = nulls[target];
+            if (!null) {
+                if (pdf.getObject(target).isDictionaryOfType("/Pages")) {
+                    null = QPDFObjectHandle::newNull();
+                } else {
+                    if (n_indirect_nulls == indirect_nulls.size()) {
+                        indirect_nulls.push_back(pdf.newIndirectNull());
+                    }
+                    null = indirect_nulls.at(n_indirect_nulls++);
+                }
+            }
+            setLink(links.at(j), null);
+            nulled_links.push_back(j);
+        }
+    }
+
+    if (!root) {
+        pages_node = pdf.makeIndirectObject(QPDFObjectHandle::newDictionary());
+        pages_node.replaceKey("/Type", QPDFObjectHandle::newName("/Pages"));
+        root = pdf.makeIndirectObject(QPDFObjectHandle::newDictionary());
+        root.replaceKey("/Type", QPDFObjectHandle::newName("/Catalog"));
+        root.replaceKey("/Pages", pages_node);
+    }
+    auto kids = QPDFObjectHandle::newArray();
+    for (size_t i = first; i <= last; ++i) {
+        auto& page = pages.at(i);
+        parents.push_back(page.getKey("/Parent"));
+        page.replaceKey("/Parent", pages_node);
+        kids.appendItem(page);
+    }
+    pages_node.replaceKey("/Kids", kids);
+    pages_node.replaceKey("/Count", QPDFObjectHandle::newInteger(kids.getArrayNItems()));
+    if (page_labels) {
+        root.replaceKey("/PageLabels", page_labels);
+    } else {
+        root.removeKey("/PageLabels");
+    }
+
+    auto pdf_trailer = pdf.getTrailer();
+    for (auto const& [key, value]: pdf_trailer.as_dictionary()) {
+        if (!value.null()) {
+            trailer[key] = value;
+        }
+    }
+    for (auto const& [key, value]: trailer) {
+        pdf_trailer.removeKey(key);
+    }
+    // As in a new file, the trailer has only /Root and /Size, whose value QPDFWriter replaces.
+    pdf_trailer.replaceKey("/Root", root);
+    pdf_trailer.replaceKey("/Size", QPDFObjectHandle::newInteger(0));
+    pdf.updateAllPagesCache();
+    selected = true;
+}
+
+void
+PageSplitter::restore()
+{
+    if (!trailer.empty()) {
+        auto pdf_trailer = pdf.getTrailer();
+        pdf_trailer.removeKey("/Root");
+        pdf_trailer.removeKey("/Size");
+        for (auto const& [key, value]: trailer) {
+            pdf_trailer.replaceKey(key, value);
+        }
+        trailer.clear();
+    }
+    for (size_t i = first; i <= last && i - first < parents.size(); ++i) {
+        pages.at(i).replaceKey("/Parent", parents.at(i - first));
+    }
+    parents.clear();
+    for (auto j: nulled_links) {
+        setLink(links.at(j), pdf.getObject(links.at(j).target));
+    }
+    nulled_links.clear();
+}
+
 QPDFJob::Members::Members() :
     log(QPDFLogger::defaultLogger())
 {
@@ -432,27 +707,63 @@ QPDFJob::parseNumrange(char const* range, int max)
     return {};
 }
 
+void
+QPDFJob::setInputQPDF(std::unique_ptr<QPDF> pdf)
+{
+    if (!pdf) {
+        throw std::logic_error("QPDFJob::setInputQPDF called with a null pointer");
+    }
+    if (!m->infilename.empty() || m->empty_input) {
+        usage("input file has already been given");
+    }
+    m->infilename = pdf->getFilename();
+    m->input_qpdf = std::move(pdf);
+}
+
+void
+QPDFJob::setChainedOutput(bool value)
+{
+    m->chained_output = value;
+}
+
 std::unique_ptr<QPDF>
 QPDFJob::createQPDF()
 {
     checkConfiguration();
+    if (!m->job_list.empty()) {
+        runJobList();
+        return nullptr;
+    }
+    if (!m->serve_socket.empty()) {
+        serve();
+        return nullptr;
+    }
     std::unique_ptr<QPDF> pdf_sp;
-    try {
-        processFile(pdf_sp, m->infilename.data(), m->password.data(), true, true);
-    } catch (QPDFExc& e) {
-        if (e.getErrorCode() == qpdf_e_password) {
-            // Allow certain operations to work when an incorrect password is supplied.
-            if (m->check_is_encrypted || m->check_requires_password) {
-                m->encryption_status = qpdf_es_encrypted | qpdf_es_password_incorrect;
-                return nullptr;
-            }
-            if (m->show_encryption && pdf_sp) {
-                m->log->info("Incorrect password supplied\n");
-                showEncryption(*pdf_sp);
-                return nullptr;
+    if (m->input_qpdf) {
+        pdf_sp = std::move(m->input_qpdf);
+        pdf_sp->setLogger(m->log);
+        if (m->suppress_warnings) {
+            pdf_sp->setSuppressWarnings(true);
+        }
+        m->max_input_version.updateIfGreater(pdf_sp->getVersionAsPDFVersion());
+    } else {
+        try {
+            processFile(pdf_sp, m->infilename.data(), m->password.data(), true, true);
+        } catch (QPDFExc& e) {
+            if (e.getErrorCode() == qpdf_e_password) {
+                // Allow certain operations to work when an incorrect password is supplied.
+                if (m->check_is_encrypted || m->check_requires_password) {
+                    m->encryption_status = qpdf_es_encrypted | qpdf_es_password_incorrect;
+                    return nullptr;
+                }
+                if (m->show_encryption && pdf_sp) {
+                    m->log->info("Incorrect password supplied\n");
+                    showEncryption(*pdf_sp);
+                    return nullptr;
+                }
             }
+            throw;
         }
-        throw;
     }
     QPDF& pdf = *pdf_sp;
     if (pdf.isEncrypted()) {
@@ -514,6 +825,11 @@ QPDFJob::writeQPDF(QPDF& pdf)
             m->warnings = true;
         }
     }
+    if (m->object_cache_limit && !m->split_pages) {
+        // All modifications have been made, so objects loaded from now on may be evicted. Objects
+        // that were already loaded stay in memory.
+        pdf.setObjectCacheLimit(m->object_cache_limit);
+    }
     if (!createsOutput()) {
         doInspection(pdf);
     } else if (m->split_pages) {
@@ -550,6 +866,207 @@ QPDFJob::run()
     }
 }
 
+namespace
+{
+    // A job list is a JSON object. Its "jobs" key is an array whose elements are job JSON objects
+    // or arrays of job JSON objects that are run as a chain. Keys in its optional "options" object
+    // are added to each job that doesn't have the same key.
+    void
+    parse_job_list(JSON const& list, JSON& options, std::vector<JSON>& jobs)
+    {
+        bool have_jobs = false;
+        bool is_dictionary = list.forEachDictItem([&](std::string const& key, JSON value) {
+            if (key == "options" && value.isDictionary()) {
+                options = value;
+            } else if (key == "jobs" && value.isArray()) {
+                have_jobs = true;
+                value.forEachArrayItem([&](JSON job) { jobs.emplace_back(job); });
+            } else if (key == "options" || key == "jobs") {
+                throw std::runtime_error(
+                    "\"" + key + "\" must be " + (key == "jobs" ? "an array" : "an object"));
+            } else {
+                throw std::runtime_error("unknown key \"" + key + "\"");
+            }
+        });
+        if (!(is_dictionary && have_jobs)) {
+            throw std::runtime_error("the job list must be an object with a \"jobs\" array");
+        }
+    }
+} // namespace
+
+void
+QPDFJob::runJobList()
+{
+    // Errors with individual jobs are reported in the summary, so anything thrown here is an error
+    // with the job list itself.
+    auto summary = JSON::makeNull();
+    try {
+        summary =
+            runJobs(JSON::parse(QUtil::read_file_into_string(m->job_list.c_str())), m->threads);
+    } catch (std::exception& e) {
+        throw std::runtime_error("error with job list " + m->job_list + ": " + e.what());
+    }
+    summary.getDictItem("jobs").forEachArrayItem([this](JSON job) {
+        std::string exit_code;
+        if (!job.getDictItem("error").isNull()) {
+            m->job_list_failed = true;
+        } else if (job.getDictItem("exitCode").getNumber(exit_code) && exit_code != "0") {
+            m->warnings = true;
+        }
+    });
+    auto info = m->log->getInfo();
+    summary.write(info.get());
+    *info << "\n";
+}
+
+JSON
+QPDFJob::runJobs(JSON const& list, size_t threads)
+{
+    JSON options = JSON::makeDictionary();
+    std::vector<JSON> jobs;
+    parse_job_list(list, options, jobs);
+
+    // Keys in options that control how output is written are only added to the last step of a
+    // chain. Find them by configuring a job with each key on its own. Invalid keys are reported by
+    // the jobs that use them.
+    std::set<std::string> writer_keys;
+    options.forEachDictItem([&writer_keys](std::string const& key, JSON value) {
+        auto single = JSON::makeDictionary();
+        single.addDictionaryMember(key, value);
+        QPDFJob probe;
+        try {
+            probe.initializeFromJson(single.unparse(), true);
+        } catch (std::exception&) {
+            return;
+        }
+        if (probe.hasWriterOptions()) {
+            writer_keys.insert(key);
+        }
+    });
+
+    struct Result
+    {
+        JSON input_file{JSON::makeNull()};
+        JSON output_file{JSON::makeNull()};
+        int exit_code{0};
+        std::string error;
+        std::string output;
+        std::string messages;
+    };
+
+    // Each job is run by its own QPDFJob with a private logger so that jobs can run on worker
+    // threads and their output can be reported in the summary.
+    auto run_job = [this, &options, &writer_keys](JSON const& job) {
+        Result result;
+        auto output = std::make_shared<Pl_String>("job output", nullptr, result.output);
+        auto messages = std::make_shared<Pl_String>("job messages", nullptr, result.messages);
+        // A job may be an array of steps. The QPDF object created by each step is the input of
+        // the next step, and only the last step writes or inspects anything.
+        std::vector<JSON> steps;
+        if (!job.forEachArrayItem([&steps](JSON step) { steps.emplace_back(step); })) {
+            steps.emplace_back(job);
+        }
+        try {
+            if (steps.empty()) {
+                usage("a chain of jobs must have at least one step");
+            }
+            // The QPDF object passed from one step to the next may refer to files opened by earlier
+            // steps, such as overlays, so all steps are kept until the last one is done.
+            std::vector<std::unique_ptr<QPDFJob>> step_jobs;
+            std::unique_ptr<QPDF> pdf;
+            bool step_warnings = false;
+            for (size_t i = 0; i < steps.size(); ++i) {
+                bool last = i + 1 == steps.size();
+                JSON config = steps.at(i);
+                if (config.isDictionary()) {
+                    config = JSON::makeDictionary();
+                    auto add = [&config](std::string const& key, JSON value) {
+                        config.addDictionaryMember(key, value);
+                    };
+                    options.forEachDictItem([&](std::string const& key, JSON value) {
+                        if (last || !writer_keys.contains(key)) {
+                            add(key, value);
+                        }
+                    });
+                    steps.at(i).forEachDictItem(add);
+                    std::string file;
+                    if (i == 0 && config.getDictItem("inputFile").getString(file)) {
+                        result.input_file = JSON::makeString(file);
+                    }
+                    if (last && config.getDictItem("outputFile").getString(file)) {
+                        result.output_file = JSON::makeString(file);
+                    }
+                }
+                // Each step gets its own logger so that a step that would write to standard
+                // output can be detected.
+                auto log = QPDFLogger::create();
+                log->setInfo(output);
+                log->setError(messages);
+                auto& j = *step_jobs.emplace_back(std::make_unique<QPDFJob>());
+                j.setLogger(log);
+                j.setMessagePrefix(m->message_prefix);
+                if (pdf) {
+                    j.setInputQPDF(std::move(pdf));
+                }
+                j.setChainedOutput(!last);
+                j.initializeFromJson(config.unparse());
+                if (log->getSave(true)) {
+                    usage("jobs in a job list may not write to standard output");
+                }
+                log->setSave(log->discard(), false);
+                if (!last) {
+                    pdf = j.createQPDF();
+                    step_warnings = step_warnings || j.hasWarnings();
+                    continue;
+                }
+                j.run();
+                result.exit_code = j.getExitCode();
+                if (step_warnings && result.exit_code == 0 && !j.m->warnings_exit_zero) {
+                    result.exit_code = EXIT_WARNING;
+                }
+            }
+        } catch (std::exception& e) {
+            result.exit_code = EXIT_ERROR;
+            result.error = e.what();
+        }
+        return result;
+    };
+
+    std::vector<std::future<Result>> results;
+    {
+        ThreadPool pool(threads);
+        for (auto const& job: jobs) {
+            results.emplace_back(pool.submit([&run_job, job]() { return run_job(job); }));
+        }
+    }
+
+    // Messages may quote strings from damaged files that are not valid UTF-8.
+    auto make_string = [](std::string const& text) {
+        bool has_8bit_chars;
+        bool is_valid_utf8;
+        bool is_utf16;
+        QUtil::analyze_encoding(text, has_8bit_chars, is_valid_utf8, is_utf16);
+        return JSON::makeString(
+            has_8bit_chars && !is_valid_utf8 ? QUtil::pdf_doc_to_utf8(text) : text);
+    };
+
+    auto summary = JSON::makeDictionary();
+    summary.addDictionaryMember("version", JSON::makeInt(1));
+    auto j_jobs = summary.addDictionaryMember("jobs", JSON::makeArray());
+    for (auto& future: results) {
+        auto result = future.get();
+        auto j_job = j_jobs.addArrayElement(JSON::makeDictionary());
+        j_job.addDictionaryMember("inputFile", result.input_file);
+        j_job.addDictionaryMember("outputFile", result.output_file);
+        j_job.addDictionaryMember("exitCode", JSON::makeInt(result.exit_code));
+        j_job.addDictionaryMember(
+            "error", result.error.empty() ? JSON::makeNull() : make_string(result.error));
+        j_job.addDictionaryMember("output", make_string(result.output));
+        j_job.addDictionaryMember("messages", make_string(result.messages));
+    }
+    return summary;
+}
+
 bool
 QPDFJob::hasWarnings() const
 {
@@ -588,6 +1105,9 @@ QPDFJob::getExitCode() const
         }
     }
 
+    if (m->job_list_failed) {
+        return EXIT_ERROR;
+    }
     if (m->warnings && (!m->warnings_exit_zero)) {
         return EXIT_WARNING;
     }
@@ -600,6 +1120,18 @@ QPDFJob::checkConfiguration()
     // Do final checks for command-line consistency. (I always think this is called doFinalChecks,
     // so I'm putting that in a comment.)
 
+    if (!(m->job_list.empty() && m->serve_socket.empty())) {
+        // Everything else is configured separately for each job.
+        std::string option = m->job_list.empty() ? "--serve" : "--job-list";
+        if (!(m->job_list.empty() || m->serve_socket.empty())) {
+            usage("--job-list and --serve may not be given together");
+        }
+        if (!(m->infilename.empty() && m->outfilename.empty() && !m->empty_input &&
+              !m->replace_input)) {
+            usage(option + " may not be used with an input or output file");
+        }
+        return;
+    }
     if (m->replace_input) {
         // Check for --empty appears later after we have checked m->infilename.
         if (!m->outfilename.empty()) {
@@ -623,7 +1155,20 @@ QPDFJob::checkConfiguration()
     if (m->replace_input && m->infilename.empty()) {
         usage("--replace-input may not be used with --empty");
     }
-    if (m->require_outfile && m->outfilename.empty() && !m->replace_input) {
+    if (m->chained_output) {
+        if (!(m->require_outfile && m->outfilename.empty() && !m->replace_input &&
+              !m->split_pages)) {
+            usage(
+                "no output file or inspection options may be given for a job whose output is "
+                "passed to another job");
+        }
+        if (hasWriterOptions()) {
+            QTC::TC("qpdf", "QPDFJob writer options in chained job");
+            usage(
+                "options that control how output is written may only be given for the last job "
+                "of a chain");
+        }
+    } else if (m->require_outfile && m->outfilename.empty() && !m->replace_input) {
         usage("an output file name is required; use - for standard output");
     }
     if (!m->require_outfile && (!m->outfilename.empty() || m->replace_input)) {
@@ -632,6 +1177,14 @@ QPDFJob::checkConfiguration()
     if (m->check_requires_password && m->check_is_encrypted) {
         usage("--requires-password and --is-encrypted may not be given together");
     }
+    if (m->incremental_update && (m->linearize || m->qdf_mode || m->encrypt || m->split_pages)) {
+        usage(
+            "--incremental-update may not be used with --linearize, --qdf, --encrypt, or "
+            "--split-pages");
+    }
+    if (!m->write_statistics.empty() && (m->split_pages || m->json_output)) {
+        usage("--write-statistics may not be used with --split-pages or --json-output");
+    }
 
     if (m->encrypt && !m->allow_insecure && m->owner_password.empty() &&
         !m->user_password.empty() && m->keylen == 256) {
@@ -693,6 +1246,15 @@ QPDFJob::setQPDFOptions(QPDF& pdf)
     if (m->suppress_recovery) {
         pdf.setAttemptRecovery(false);
     }
+    if (m->use_mmap) {
+        pdf.setUseMmap(true);
+    }
+    if (m->use_object_arena) {
+        pdf.setUseObjectArena(true);
+    }
+    if (m->threads != 1) {
+        pdf.setObjectStreamDecodeThreads(m->threads);
+    }
     if (m->password_is_hex_key) {
         pdf.setPasswordIsHexKey(true);
     }
@@ -820,6 +1382,7 @@ QPDFJob::doCheck(QPDF& pdf)
                 okay = false;
                 *m->log->getError() << "ERROR: page " << pageno << ": " << e.what() << "\n";
             }
+            pdf.trimObjectCache();
         }
     } catch (std::exception& e) {
         *m->log->getError() << "ERROR: " << e.what() << "\n";
@@ -1010,6 +1573,7 @@ QPDFJob::doJSONObjects(Pipeline* p, bool& first, QPDF& pdf)
                 obj.writeJSON(1, p, true, 2);
                 first_object = false;
             }
+            pdf.trimObjectCache();
         }
         if (all_objects || m->json_objects.contains("trailer")) {
             JSON::writeDictionaryKey(p, first_object, "trailer", 2);
@@ -2486,8 +3050,16 @@ QPDFJob::handlePageSpecs(QPDF& pdf, std::vector<std::unique_ptr<QPDF>>& page_hea
                 cis->stayOpen(true);
             } else {
                 QTC::TC("qpdf", "QPDFJob keep files open y");
-                FileInputSource* fis = new FileInputSource(page_spec.filename.c_str());
-                is = std::shared_ptr<InputSource>(fis);
+                if (m->use_mmap) {
+                    try {
+                        is = std::make_shared<MmapInputSource>(page_spec.filename.c_str());
+                    } catch (std::exception&) {
+                        // Fall back to FileInputSource below.
+                    }
+                }
+                if (!is) {
+                    is = std::make_shared<FileInputSource>(page_spec.filename.c_str());
+                }
             }
             std::unique_ptr<QPDF> qpdf_sp;
             processInputSource(qpdf_sp, is, password.data(), true);
@@ -2941,6 +3513,21 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
     if (m->decode_level_set) {
         w.setDecodeLevel(m->decode_level);
     }
+    if (m->threads != 1) {
+        w.setCompressionThreads(m->threads);
+    }
+    if (m->buffer_memory_limit) {
+        w.setBufferMemoryLimit(m->buffer_memory_limit);
+    }
+    if (m->output_buffer_size) {
+        w.setOutputBufferSize(m->output_buffer_size);
+    }
+    if (m->sync_output) {
+        w.setSyncOutput(true);
+    }
+    if (m->deduplicate_objects) {
+        w.setDeduplicateObjects(true);
+    }
     if (m->decrypt) {
         w.setPreserveEncryption(false);
     }
@@ -2972,9 +3559,18 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
     if (m->linearize) {
         w.setLinearization(true);
     }
+    if (m->linearize_cache) {
+        w.setLinearizationObjectCache(true);
+    }
+    if (m->incremental_update) {
+        w.setIncrementalUpdate(true);
+    }
     if (!m->linearize_pass1.empty()) {
         w.setLinearizationPass1Filename(m->linearize_pass1);
     }
+    if (!m->write_statistics.empty()) {
+        w.setCollectStatistics(true);
+    }
     if (m->object_stream_set) {
         w.setObjectStreamMode(m->object_stream_mode);
     }
@@ -2995,7 +3591,11 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
         if (m->progress_handler) {
             w.registerProgressReporter(
                 std::shared_ptr<QPDFWriter::ProgressReporter>(
-                    new QPDFWriter::FunctionProgressReporter(m->progress_handler)));
+                    new QPDFWriter::FunctionProgressReporter(
+                        [handler = m->progress_handler](int p) {
+                            std::lock_guard lock(output_mutex);
+                            handler(p);
+                        })));
         } else {
             char const* outfilename =
                 !m->outfilename.empty() ? m->outfilename.data() : "standard output";
@@ -3007,6 +3607,21 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
     }
 }
 
+bool
+QPDFJob::hasWriterOptions() const
+{
+    // Return true if any option that setWriterOptions passes to QPDFWriter has been given. Options
+    // that also affect reading or processing, such as --threads, are not included.
+    return m->compression_level >= 0 || m->qdf_mode || m->preserve_unreferenced_objects ||
+        m->newline_before_endstream || m->normalize_set || m->stream_data_set ||
+        m->compress_streams_set || m->recompress_flate_set || m->decode_level_set ||
+        m->deduplicate_objects || m->decrypt || m->deterministic_id || m->static_id ||
+        m->static_aes_iv || m->suppress_original_object_id || m->copy_encryption || m->encrypt ||
+        m->linearize || m->linearize_cache || m->incremental_update ||
+        !m->linearize_pass1.empty() || !m->write_statistics.empty() || m->object_stream_set ||
+        !m->min_version.empty() || !m->force_version.empty();
+}
+
 void
 QPDFJob::doSplitPages(QPDF& pdf)
 {
@@ -3033,26 +3648,103 @@ QPDFJob::doSplitPages(QPDF& pdf)
         QPDFPageDocumentHelper dh(pdf);
         dh.removeUnreferencedResources();
     }
-    QPDFPageLabelDocumentHelper pldh(pdf);
-    QPDFAcroFormDocumentHelper afdh(pdf);
-    std::vector<QPDFObjectHandle> const& pages = pdf.getAllPages();
-    size_t pageno_len = std::to_string(pages.size()).length();
-    size_t num_pages = pages.size();
-    for (size_t i = 0; i < num_pages; i += QIntC::to_size(m->split_pages)) {
-        size_t first = i + 1;
-        size_t last = i + QIntC::to_size(m->split_pages);
-        if (last > num_pages) {
-            last = num_pages;
+    if (m->object_cache_limit) {
+        pdf.setObjectCacheLimit(m->object_cache_limit);
+    }
+    size_t num_pages = pdf.getAllPages().size();
+    size_t pageno_len = std::to_string(num_pages).length();
+    auto split_size = QIntC::to_size(m->split_pages);
+    // With worker threads, output files are written in parallel from a renumbered copy of pdf. The
+    // original object IDs written in QDF mode would be those of the copy, so such files are
+    // written sequentially.
+    bool parallel = m->threads != 1 && num_pages > split_size &&
+        !(m->qdf_mode && !m->suppress_original_object_id);
+
+    auto output_filename = [&](size_t first, size_t last) {
+        std::string page_range = QUtil::uint_to_string(first, QIntC::to_int(pageno_len));
+        if (m->split_pages > 1) {
+            page_range += "-" + QUtil::uint_to_string(last, QIntC::to_int(pageno_len));
         }
-        QPDF outpdf;
+        std::string outfile = before + page_range + after;
+        if (QUtil::same_file(m->infilename.data(), outfile.data())) {
+            throw std::runtime_error("split pages would overwrite input file with " + outfile);
+        }
+        return outfile;
+    };
+
+    // Pages are written straight from the input file when possible. Otherwise, they are copied to
+    // a new file, which also takes care of fixing up form fields.
+    auto make_splitter = [this](QPDF& in, QPDFAcroFormDocumentHelper& afdh) {
+        std::unique_ptr<PageSplitter> splitter;
+        if (!afdh.hasAcroForm() && !m->linearize && !m->preserve_unreferenced_objects &&
+            !m->incremental_update && !(m->qdf_mode && !m->suppress_original_object_id)) {
+            splitter = std::make_unique<PageSplitter>(in, QPDF::JobSetter::getPageObjects(in));
+            if (!splitter->usable()) {
+                splitter.reset();
+            }
+        }
+        return splitter;
+    };
+
+    // Write pages first through last of in, which are numbered from 1, to outfile.
+    auto write_pages = [this, parallel](
+                           QPDF& in,
+                           QPDFPageLabelDocumentHelper& pldh,
+                           QPDFAcroFormDocumentHelper& afdh,
+                           PageSplitter* splitter,
+                           QPDF& outpdf,
+                           size_t first,
+                           size_t last,
+                           std::string const& outfile) {
+        QPDFObjectHandle page_labels;
+        if (pldh.hasPageLabels()) {
+            std::vector<QPDFObjectHandle> labels;
+            pldh.getLabelsForPageRange(
+                QIntC::to_longlong(first - 1), QIntC::to_longlong(last - 1), 0, labels);
+            page_labels = QPDFObjectHandle::newDictionary();
+            page_labels.replaceKey("/Nums", QPDFObjectHandle::newArray(labels));
+        }
+        auto write = [&](QPDF& qpdf) {
+            QPDFWriter w(qpdf, outfile.c_str());
+            if (!parallel) {
+                setWriterOptions(w);
+            } else {
+                std::lock_guard lock(output_mutex);
+                setWriterOptions(w);
+                // The files are already being written in parallel.
+                w.setCompressionThreads(1);
+            }
+            if (splitter) {
+                // Write the same file as when the pages are copied to a new empty file, which is
+                // PDF 1.3 and has no object streams to preserve.
+                w.setMinimumPDFVersion("1.3");
+                if (!m->object_stream_set || m->object_stream_mode == qpdf_o_preserve) {
+                    w.setObjectStreamMode(qpdf_o_disable);
+                }
+            }
+            w.write();
+        };
+
+        if (splitter) {
+            QTC::TC("qpdf", "QPDFJob split pages from input file");
+            splitter->select(first - 1, last - 1, page_labels);
+            try {
+                write(in);
+            } catch (...) {
+                splitter->restore();
+                throw;
+            }
+            splitter->restore();
+
+            return;
+        }
+
+        std::vector<QPDFObjectHandle> const& pages = in.getAllPages();
         outpdf.emptyPDF();
         std::shared_ptr<QPDFAcroFormDocumentHelper> out_afdh;
         if (afdh.hasAcroForm()) {
             out_afdh = std::make_shared<QPDFAcroFormDocumentHelper>(outpdf);
         }
-        if (m->suppress_warnings) {
-            outpdf.setSuppressWarnings(true);
-        }
         for (size_t pageno = first; pageno <= last; ++pageno) {
             QPDFObjectHandle page = pages.at(pageno - 1);
             outpdf.addPage(page, false);
@@ -3062,7 +3754,7 @@ QPDFJob::doSplitPages(QPDF& pdf)
                 try {
                     out_afdh->fixCopiedAnnotations(new_page, page, afdh);
                 } catch (std::exception& e) {
-                    pdf.warn(
+                    in.warn(
                         qpdf_e_damaged_pdf,
                         "",
                         0,
@@ -3072,28 +3764,149 @@ QPDFJob::doSplitPages(QPDF& pdf)
                 }
             }
         }
-        if (pldh.hasPageLabels()) {
-            std::vector<QPDFObjectHandle> labels;
-            pldh.getLabelsForPageRange(
-                QIntC::to_longlong(first - 1), QIntC::to_longlong(last - 1), 0, labels);
-            QPDFObjectHandle page_labels = QPDFObjectHandle::newDictionary();
-            page_labels.replaceKey("/Nums", QPDFObjectHandle::newArray(labels));
+        if (page_labels) {
             outpdf.getRoot().replaceKey("/PageLabels", page_labels);
         }
-        std::string page_range = QUtil::uint_to_string(first, QIntC::to_int(pageno_len));
-        if (m->split_pages > 1) {
-            page_range += "-" + QUtil::uint_to_string(last, QIntC::to_int(pageno_len));
-        }
-        std::string outfile = before + page_range + after;
-        if (QUtil::same_file(m->infilename.data(), outfile.data())) {
-            throw std::runtime_error("split pages would overwrite input file with " + outfile);
+        write(outpdf);
+    };
+
+    if (!parallel) {
+        QPDFPageLabelDocumentHelper pldh(pdf);
+        QPDFAcroFormDocumentHelper afdh(pdf);
+        auto splitter = make_splitter(pdf, afdh);
+        for (size_t i = 0; i < num_pages; i += split_size) {
+            size_t first = i + 1;
+            size_t last = std::min(i + split_size, num_pages);
+            std::string outfile = output_filename(first, last);
+            QPDF outpdf;
+            outpdf.setLogger(m->log);
+            if (m->suppress_warnings) {
+                outpdf.setSuppressWarnings(true);
+            }
+            write_pages(pdf, pldh, afdh, splitter.get(), outpdf, first, last, outfile);
+            if (outpdf.anyWarnings()) {
+                m->warnings = true;
+            }
+            pdf.trimObjectCache();
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": wrote file " << outfile << "\n";
+            });
         }
-        QPDFWriter w(outpdf, outfile.c_str());
-        setWriterOptions(w);
+        return;
+    }
+
+    // QPDF objects can't be shared between threads, so each worker thread reads its own copy of
+    // the file. The file is written to memory once first so that the copies include all changes
+    // that were made to pdf. Stream data is written as it is, and encryption is removed.
+    QTC::TC("qpdf", "QPDFJob split pages in parallel");
+    auto copy_name = m->infilename + " (copy for splitting pages)";
+    // Analyze the form here so that warnings about it are issued once with the original object
+    // numbers.
+    QPDFAcroFormDocumentHelper afdh(pdf);
+    std::shared_ptr<Buffer> copy;
+    {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setPreserveEncryption(false);
+        w.setDecodeLevel(qpdf_dl_none);
+        w.setCompressStreams(false);
+        w.setObjectStreamMode(qpdf_o_disable);
         w.write();
-        doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": wrote file " << outfile << "\n";
-        });
+        copy = w.getBufferSharedPointer();
+    }
+    if (!pdf.getWarnings().empty()) {
+        // getWarnings clears the warnings, so make sure they are still reported.
+        m->warnings = true;
+    }
+
+    struct Source
+    {
+        std::unique_ptr<QPDF> qpdf;
+        std::unique_ptr<QPDFPageLabelDocumentHelper> pldh;
+        std::unique_ptr<QPDFAcroFormDocumentHelper> afdh;
+        std::unique_ptr<PageSplitter> splitter;
+    };
+    std::mutex sources_mutex;
+    std::map<std::thread::id, Source> sources;
+    auto get_source = [&]() -> Source& {
+        Source* source;
+        {
+            std::lock_guard lock(sources_mutex);
+            source = &sources[std::this_thread::get_id()];
+        }
+        if (!source->qpdf) {
+            source->qpdf = std::make_unique<QPDF>();
+            source->qpdf->setSuppressWarnings(true);
+            source->qpdf->processMemoryFile(
+                copy_name.data(),
+                reinterpret_cast<char const*>(copy->getBuffer()),
+                copy->getSize());
+            if (m->object_cache_limit) {
+                source->qpdf->setObjectCacheLimit(m->object_cache_limit);
+            }
+            source->pldh = std::make_unique<QPDFPageLabelDocumentHelper>(*source->qpdf);
+            source->afdh = std::make_unique<QPDFAcroFormDocumentHelper>(*source->qpdf);
+            source->splitter = make_splitter(*source->qpdf, *source->afdh);
+            // Any warnings so far repeat the ones issued for pdf when it was analyzed and written.
+            source->qpdf->getWarnings();
+        }
+        return *source;
+    };
+
+    // Warnings are issued by the main thread in page order. Warnings about the copy are issued
+    // through pdf without the copy's object numbers and offsets, which don't match those of the
+    // input. Warnings about the output files are issued the same way as when the files are written
+    // on the main thread.
+    using Warnings = std::pair<std::vector<QPDFExc>, std::vector<QPDFExc>>;
+    std::atomic<bool> cancel{false};
+    std::vector<std::pair<std::string, std::future<Warnings>>> results;
+    ThreadPool pool(m->threads);
+    for (size_t i = 0; i < num_pages; i += split_size) {
+        size_t first = i + 1;
+        size_t last = std::min(i + split_size, num_pages);
+        std::string outfile = output_filename(first, last);
+        results.emplace_back(outfile, pool.submit([&, first, last, outfile]() -> Warnings {
+            if (cancel) {
+                return {};
+            }
+            auto& source = get_source();
+            QPDF outpdf;
+            outpdf.setSuppressWarnings(true);
+            write_pages(
+                *source.qpdf,
+                *source.pldh,
+                *source.afdh,
+                source.splitter.get(),
+                outpdf,
+                first,
+                last,
+                outfile);
+            source.qpdf->trimObjectCache();
+            return {source.qpdf->getWarnings(), outpdf.getWarnings()};
+        }));
+    }
+    try {
+        for (auto& [outfile, result]: results) {
+            auto [in_warnings, out_warnings] = result.get();
+            std::lock_guard lock(output_mutex);
+            for (auto const& e: in_warnings) {
+                pdf.warn(QPDFExc(e.getErrorCode(), e.getFilename(), "", 0, e.getMessageDetail()));
+            }
+            if (!out_warnings.empty()) {
+                m->warnings = true;
+            }
+            if (!m->suppress_warnings) {
+                for (auto const& e: out_warnings) {
+                    *m->log->getWarn() << "WARNING: " << e.what() << "\n";
+                }
+            }
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": wrote file " << outfile << "\n";
+            });
+        }
+    } catch (...) {
+        cancel = true;
+        throw;
     }
 }
 
@@ -3126,6 +3939,13 @@ QPDFJob::writeOutfile(QPDF& pdf)
         }
         setWriterOptions(w);
         w.write();
+        if (!m->write_statistics.empty()) {
+            QUtil::FileCloser fc(QUtil::safe_fopen(m->write_statistics.data(), "w"));
+            Pl_StdioFile f("statistics", fc.f);
+            w.getStatistics().getJSON().write(&f);
+            f << "\n";
+            f.finish();
+        }
     }
     if (!m->outfilename.empty()) {
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
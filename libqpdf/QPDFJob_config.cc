@@ -76,6 +76,13 @@ QPDFJob::Config::check()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::bufferMemoryLimit(std::string const& parameter)
+{
+    o.m->buffer_memory_limit = QIntC::to_size(QUtil::string_to_ull(parameter.c_str()));
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::checkLinearization()
 {
@@ -165,6 +172,13 @@ QPDFJob::Config::decrypt()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::deduplicateObjects()
+{
+    o.m->deduplicate_objects = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::deterministicId()
 {
@@ -242,6 +256,13 @@ QPDFJob::Config::iiMinBytes(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::incrementalUpdate()
+{
+    o.m->incremental_update = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::isEncrypted()
 {
@@ -374,6 +395,13 @@ QPDFJob::Config::linearize()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::linearizeCache()
+{
+    o.m->linearize_cache = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::linearizePass1(std::string const& parameter)
 {
@@ -425,6 +453,13 @@ QPDFJob::Config::normalizeContent(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::objectCacheLimit(std::string const& parameter)
+{
+    o.m->object_cache_limit = QUtil::string_to_uint(parameter.c_str());
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::oiMinArea(std::string const& parameter)
 {
@@ -453,6 +488,13 @@ QPDFJob::Config::optimizeImages()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::outputBufferSize(std::string const& parameter)
+{
+    o.m->output_buffer_size = QIntC::to_size(QUtil::string_to_ull(parameter.c_str()));
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::password(std::string const& parameter)
 {
@@ -664,6 +706,34 @@ QPDFJob::Config::suppressRecovery()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::syncOutput()
+{
+    o.m->sync_output = true;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::threads(std::string const& parameter)
+{
+    o.m->threads = QUtil::string_to_uint(parameter.c_str());
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::useMmap()
+{
+    o.m->use_mmap = true;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::useObjectArena()
+{
+    o.m->use_object_arena = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::verbose()
 {
@@ -685,6 +755,13 @@ QPDFJob::Config::withImages()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::writeStatistics(std::string const& parameter)
+{
+    o.m->write_statistics = parameter;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::passwordFile(std::string const& parameter)
 {
@@ -798,6 +875,20 @@ QPDFJob::Config::showObject(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::jobList(std::string const& parameter)
+{
+    o.m->job_list = parameter;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::serve(std::string const& parameter)
+{
+    o.m->serve_socket = parameter;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::jobJsonFile(std::string const& parameter)
 {
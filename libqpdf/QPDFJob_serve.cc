@@ -0,0 +1,314 @@
+#include <qpdf/QPDFJob.hh>
+
+#include <qpdf/QUtil.hh>
+#include <qpdf/ThreadPool.hh>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+# include <poll.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+# include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+void
+QPDFJob::serve()
+{
+    throw std::runtime_error("--serve is not supported on this platform");
+}
+
+#else
+
+namespace
+{
+    // A client that hasn't sent its whole request within this time gets an error response, and one
+    // that hasn't read its whole response within this time is disconnected.
+    constexpr auto client_timeout = std::chrono::seconds(30);
+    // Larger requests are read to the end and discarded, and the client gets an error response.
+    constexpr size_t max_request_size = 16 << 20;
+    // At most this many requests are read at the same time. Other clients wait in the listen queue.
+    constexpr size_t max_pending_connections = 64;
+    // After running out of file descriptors or memory, connections are accepted again when a
+    // connection whose request is being read is closed or after this time.
+    constexpr auto accept_retry_delay = std::chrono::seconds(1);
+
+    // Close a file descriptor when it goes out of scope.
+    class FileDescriptor
+    {
+      public:
+        explicit FileDescriptor(int fd = -1) :
+            fd(fd)
+        {
+        }
+        FileDescriptor(FileDescriptor&& other) noexcept :
+            fd(std::exchange(other.fd, -1))
+        {
+        }
+        FileDescriptor(FileDescriptor const&) = delete;
+        FileDescriptor& operator=(FileDescriptor const&) = delete;
+        ~FileDescriptor()
+        {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        int fd;
+    };
+
+    // A connection whose request is being read. Requests are terminated by the client shutting
+    // down its side of the connection.
+    struct Connection
+    {
+        FileDescriptor socket;
+        std::string request;
+        bool too_large{false};
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    // Give up if the client doesn't read the response in time. Errors are ignored since there is
+    // nobody to report them to if the client has gone away.
+    void
+    write_response(int fd, std::string const& response)
+    {
+        int flags = MSG_DONTWAIT;
+# ifdef MSG_NOSIGNAL
+        flags |= MSG_NOSIGNAL;
+# endif
+        auto deadline = std::chrono::steady_clock::now() + client_timeout;
+        size_t offset = 0;
+        while (offset < response.size()) {
+            auto len = send(fd, response.data() + offset, response.size() - offset, flags);
+            if (len >= 0) {
+                offset += static_cast<size_t>(len);
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return;
+            }
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            pollfd pfd{fd, POLLOUT, 0};
+            if (wait.count() <= 0 ||
+                (poll(&pfd, 1, static_cast<int>(wait.count())) < 0 && errno != EINTR)) {
+                return;
+            }
+        }
+    }
+
+    void
+    write_error(int fd, std::string const& message)
+    {
+        auto response = JSON::makeDictionary();
+        response.addDictionaryMember("version", JSON::makeInt(1));
+        response.addDictionaryMember("error", JSON::makeString(message));
+        write_response(fd, response.unparse() + "\n");
+    }
+} // namespace
+
+void
+QPDFJob::serve()
+{
+    auto const& path = m->serve_socket;
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket name " + path + " is too long");
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.data(), path.size());
+    auto sockaddr_p = reinterpret_cast<sockaddr*>(&address);
+
+    FileDescriptor listener(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (listener.fd < 0) {
+        QUtil::throw_system_error("create socket");
+    }
+    if (bind(listener.fd, sockaddr_p, sizeof(address)) != 0) {
+        if (errno != EADDRINUSE) {
+            QUtil::throw_system_error("bind " + path);
+        }
+        // Replace a socket left behind by a server that is no longer running, but don't take over
+        // the socket of one that is or remove anything that isn't a socket.
+        struct stat st;
+        if (!(lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))) {
+            errno = EADDRINUSE;
+            QUtil::throw_system_error("bind " + path);
+        }
+        FileDescriptor probe(socket(AF_UNIX, SOCK_STREAM, 0));
+        if (probe.fd >= 0 && connect(probe.fd, sockaddr_p, sizeof(address)) == 0) {
+            throw std::runtime_error("a server is already listening on " + path);
+        }
+        unlink(path.c_str());
+        if (bind(listener.fd, sockaddr_p, sizeof(address)) != 0) {
+            QUtil::throw_system_error("bind " + path);
+        }
+    }
+    if (listen(listener.fd, SOMAXCONN) != 0) {
+        unlink(path.c_str());
+        QUtil::throw_system_error("listen on " + path);
+    }
+
+    // Each request is a job list, and the response is its summary. Requests are read on this
+    // thread, so clients that are slow to send them don't hold up worker threads, and a request to
+    // stop the server is handled here. The jobs of one request are run one after another on a
+    // worker thread, and requests are handled in parallel.
+    auto run = [this](FileDescriptor& socket, JSON const& request) {
+        std::string response;
+        try {
+            response = runJobs(request, 1).unparse() + "\n";
+        } catch (std::exception& e) {
+            write_error(socket.fd, e.what());
+            return;
+        }
+        write_response(socket.fd, response);
+    };
+
+    doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+        v << prefix << ": listening on " << path << "\n";
+    });
+    try {
+        ThreadPool pool(m->threads);
+        std::list<Connection> connections;
+        bool stopping = false;
+        // Handle a complete request. Return true if the server should stop.
+        auto handle = [&pool, &run](Connection& c) {
+            if (c.too_large) {
+                write_error(
+                    c.socket.fd,
+                    "request is larger than " + std::to_string(max_request_size) + " bytes");
+                return false;
+            }
+            JSON request;
+            try {
+                request = JSON::parse(c.request);
+                bool stop = false;
+                if (request.isDictionary() && request.getDictItem("stop").getBool(stop)) {
+                    if (!stop) {
+                        throw std::runtime_error("\"stop\" may only be true");
+                    }
+                    auto response = JSON::makeDictionary();
+                    response.addDictionaryMember("version", JSON::makeInt(1));
+                    response.addDictionaryMember("stopped", JSON::makeBool(true));
+                    write_response(c.socket.fd, response.unparse() + "\n");
+                    return true;
+                }
+            } catch (std::exception& e) {
+                write_error(c.socket.fd, e.what());
+                return false;
+            }
+            pool.submit([&run, socket = std::move(c.socket), request]() mutable {
+                run(socket, request);
+            });
+            return false;
+        };
+
+        std::vector<pollfd> fds;
+        auto accept_retry = std::chrono::steady_clock::time_point::min();
+        while (!stopping) {
+            auto now = std::chrono::steady_clock::now();
+            fds.clear();
+            for (auto const& c: connections) {
+                fds.push_back({c.socket.fd, POLLIN, 0});
+            }
+            // While the listener isn't polled, new clients wait in the listen queue.
+            bool accepting = connections.size() < max_pending_connections && now >= accept_retry;
+            if (accepting) {
+                fds.push_back({listener.fd, POLLIN, 0});
+            }
+            // Connections are in the order in which they were accepted, so the first one has the
+            // earliest deadline.
+            auto wake = std::chrono::steady_clock::time_point::max();
+            if (!connections.empty()) {
+                wake = connections.front().deadline;
+            }
+            if (!accepting && connections.size() < max_pending_connections) {
+                wake = std::min(wake, accept_retry);
+            }
+            int timeout = -1;
+            if (wake != std::chrono::steady_clock::time_point::max()) {
+                auto wait = std::chrono::ceil<std::chrono::milliseconds>(wake - now);
+                timeout = wait.count() > 0 ? static_cast<int>(wait.count()) : 0;
+            }
+            if (poll(fds.data(), fds.size(), timeout) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                QUtil::throw_system_error("wait for connections");
+            }
+            now = std::chrono::steady_clock::now();
+            auto fd_iter = fds.begin();
+            for (auto c = connections.begin(); c != connections.end(); ++fd_iter) {
+                bool done = false;
+                if (fd_iter->revents) {
+                    char buf[8192];
+                    auto len = recv(c->socket.fd, buf, sizeof(buf), 0);
+                    if (len > 0) {
+                        if (c->request.size() + static_cast<size_t>(len) > max_request_size) {
+                            c->too_large = true;
+                            c->request.clear();
+                        }
+                        if (!c->too_large) {
+                            c->request.append(buf, static_cast<size_t>(len));
+                        }
+                    } else if (len == 0) {
+                        stopping = handle(*c) || stopping;
+                        done = true;
+                    } else if (errno != EINTR && errno != EAGAIN) {
+                        done = true;
+                    }
+                } else if (now >= c->deadline) {
+                    write_error(c->socket.fd, "timed out waiting for request");
+                    done = true;
+                }
+                if (done) {
+                    c = connections.erase(c);
+                    accept_retry = std::chrono::steady_clock::time_point::min();
+                } else {
+                    ++c;
+                }
+            }
+            if (accepting && fds.back().revents && !stopping) {
+                int fd = accept(listener.fd, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                        // Connections handled by worker threads are closed there, so try again
+                        // after a while even if none of the pending connections is closed.
+                        accept_retry = now + accept_retry_delay;
+                    } else if (errno != EINTR && errno != ECONNABORTED) {
+                        QUtil::throw_system_error("accept connection");
+                    }
+                    continue;
+                }
+# ifdef SO_NOSIGPIPE
+                int on = 1;
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+# endif
+                connections.push_back({FileDescriptor(fd), {}, false, now + client_timeout});
+            }
+        }
+        // Connections whose requests haven't been received are closed, and the pool's destructor
+        // waits for requests that are already being handled.
+    } catch (...) {
+        unlink(path.c_str());
+        throw;
+    }
+    unlink(path.c_str());
+    doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+        v << prefix << ": stopped listening on " << path << "\n";
+    });
+}
+
+#endif // _WIN32
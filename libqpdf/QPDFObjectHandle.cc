@@ -341,11 +341,13 @@ BaseHandle::copy(bool shallow) const
             if (shallow) {
                 return QPDFObject::create<QPDF_Dictionary>(d.items);
             } else {
-                std::map<std::string, QPDFObjectHandle> new_items;
-                for (auto const& [key, val]: d.items) {
-                    new_items[key] = val.indirect() ? val : val.copy();
+                QPDF_Dictionary::Items new_items(d.items);
+                for (auto& [key, val]: new_items) {
+                    if (!val.indirect()) {
+                        val = val.copy();
+                    }
                 }
-                return QPDFObject::create<QPDF_Dictionary>(new_items);
+                return QPDFObject::create<QPDF_Dictionary>(std::move(new_items));
             }
         }
     case ::ot_stream:
@@ -495,7 +497,7 @@ BaseHandle::write_json(int json_version, JSON::Writer& p) const
             } else {
                 if (auto res = Name::analyzeJSONEncoding(n.name); res.first) {
                     if (res.second) {
-                        p << "\"" << n.name << "\"";
+                        p << "\"" << n.name.view() << "\"";
                     } else {
                         p << "\"" << JSON::Writer::encode_string(n.name) << "\"";
                     }
@@ -554,7 +556,7 @@ BaseHandle::write_json(int json_version, JSON::Writer& p) const
                           << "\": ";
                     } else if (auto res = Name::analyzeJSONEncoding(iter.first); res.first) {
                         if (res.second) {
-                            p << "\"" << iter.first << "\": ";
+                            p << "\"" << iter.first.view() << "\": ";
                         } else {
                             p << "\"" << JSON::Writer::encode_string(iter.first) << "\": ";
                         }
@@ -623,6 +625,14 @@ BaseHandle::disconnect(bool only_direct)
     obj->og = QPDFObjGen();
 }
 
+void
+QPDFObject::modified()
+{
+    if (qpdf) {
+        QPDF::Resolver::modified(qpdf, *this);
+    }
+}
+
 std::string
 QPDFObject::getStringValue() const
 {
@@ -805,7 +815,8 @@ QPDFObjectHandle::isScalar() const
 bool
 QPDFObjectHandle::isNameAndEquals(std::string const& name) const
 {
-    return isName() && (getName() == name);
+    auto n = as<QPDF_Name>();
+    return n && n->name == name;
 }
 
 bool
@@ -1193,7 +1204,7 @@ QPDFObjectHandle::mergeResources(
                         } else {
                             QTC::TC("qpdf", "QPDFObjectHandle merge generate");
                             std::string new_key =
-                                getUniqueResourceName(key + "_", min_suffix, &rnames);
+                                getUniqueResourceName(key.str() + "_", min_suffix, &rnames);
                             (*conflicts)[rtype][key] = new_key;
                             this_val.replaceKey(new_key, rval);
                         }
@@ -1614,7 +1625,7 @@ QPDFObjectHandle::parseContentStream_data(
     QPDF* context)
 {
     size_t stream_length = stream_data->getSize();
-    auto input = BufferInputSource(description, stream_data.get());
+    is::OffsetBuffer input(description, stream_data.get(), 0);
     Tokenizer tokenizer;
     tokenizer.allowEOF();
     auto sp_description = QPDFParser::make_description(description, "content");
@@ -1919,14 +1930,14 @@ QPDFObjectHandle::makeDirect(QPDFObjGen::set& visited, bool stop_at_streams)
         }
         obj = QPDFObject::create<QPDF_Array>(items);
     } else if (isDictionary()) {
-        std::map<std::string, QPDFObjectHandle> items;
+        QPDF_Dictionary::Items items;
         for (auto const& [key, value]: as_dictionary(strict)) {
             if (!value.null()) {
-                items.insert({key, value});
-                items[key].makeDirect(visited, stop_at_streams);
+                items.insert_or_assign(key, value).first->second.makeDirect(
+                    visited, stop_at_streams);
             }
         }
-        obj = QPDFObject::create<QPDF_Dictionary>(items);
+        obj = QPDFObject::create<QPDF_Dictionary>(std::move(items));
     } else if (isStream()) {
         QTC::TC("qpdf", "QPDFObjectHandle copy stream", stop_at_streams ? 0 : 1);
         if (!stop_at_streams) {
@@ -77,7 +77,7 @@ InlineImageTracker::convertIIDict(QPDFObjectHandle odict)
         if (v.null()) {
             continue;
         }
-        auto key = k;
+        std::string key = k;
         auto value = v;
         if (key == "/BPC") {
             key = "/BitsPerComponent";
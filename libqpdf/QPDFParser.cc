@@ -34,14 +34,13 @@ QPDFParser::parse(InputSource& input, std::string const& object_description, QPD
 
 QPDFObjectHandle
 QPDFParser::parse_content(
-    InputSource& input,
+    is::OffsetBuffer& input,
     std::shared_ptr<QPDFObject::Description> sp_description,
     qpdf::Tokenizer& tokenizer,
     QPDF* context)
 {
     bool empty = false;
-    return QPDFParser(
-               input, std::move(sp_description), "content", tokenizer, nullptr, context, true)
+    return QPDFParser(input, std::move(sp_description), "content", tokenizer, context)
         .parse(empty, true);
 }
 
@@ -101,9 +100,7 @@ QPDFParser::parse(
                           QPDFObject::ObjStreamDescr(stream_id, obj_id)),
                       "",
                       tokenizer,
-                      nullptr,
                       &context,
-                      true,
                       stream_id,
                       obj_id)
                       .parse(empty, false);
@@ -122,7 +119,7 @@ QPDFParser::parse(bool& empty, bool content_stream)
     empty = false;
     start = input.tell();
 
-    if (!tokenizer.nextToken(input, object_description)) {
+    if (!nextToken()) {
         warn(tokenizer.getErrorMessage());
     }
 
@@ -213,6 +210,13 @@ QPDFParser::parse(bool& empty, bool content_stream)
     }
 }
 
+bool
+QPDFParser::nextToken()
+{
+    return buffer ? tokenizer.nextToken(*buffer, object_description)
+                  : tokenizer.nextToken(input, object_description);
+}
+
 QPDFObjectHandle
 QPDFParser::parseRemainder(bool content_stream)
 {
@@ -225,7 +229,7 @@ QPDFParser::parseRemainder(bool content_stream)
     bool b_contents = false;
 
     while (true) {
-        if (!tokenizer.nextToken(input, object_description)) {
+        if (!nextToken()) {
             warn(tokenizer.getErrorMessage());
         }
         ++good_count; // optimistically
@@ -309,8 +313,8 @@ QPDFParser::parseRemainder(bool content_stream)
             }
             if (frame->state == st_array) {
                 auto object = frame->null_count > 100
-                    ? QPDFObject::create<QPDF_Array>(std::move(frame->olist), true)
-                    : QPDFObject::create<QPDF_Array>(std::move(frame->olist));
+                    ? QPDFObject::create_in<QPDF_Array>(arena, std::move(frame->olist), true)
+                    : QPDFObject::create_in<QPDF_Array>(arena, std::move(frame->olist));
                 setDescription(object, frame->offset - 1);
                 // The `offset` points to the next of "[".  Set the rewind offset to point to the
                 // beginning of "[". This has been explicitly tested with whitespace surrounding the
@@ -360,7 +364,7 @@ QPDFParser::parseRemainder(bool content_stream)
                     dict["/Contents"] = QPDFObjectHandle::newString(frame->contents_string);
                     dict["/Contents"].setParsedOffset(frame->contents_offset);
                 }
-                auto object = QPDFObject::create<QPDF_Dictionary>(std::move(dict));
+                auto object = QPDFObject::create_in<QPDF_Dictionary>(arena, std::move(dict));
                 setDescription(object, frame->offset - 2);
                 // The `offset` points to the next of "<<". Set the rewind offset to point to the
                 // beginning of "<<". This has been explicitly tested with whitespace surrounding
@@ -509,7 +513,7 @@ QPDFParser::addNull()
 void
 QPDFParser::addInt(int count)
 {
-    auto obj = QPDFObject::create<QPDF_Integer>(int_buffer[count % 2]);
+    auto obj = QPDFObject::create_in<QPDF_Integer>(arena, int_buffer[count % 2]);
     obj->setDescription(context, description, last_offset_buffer[count % 2]);
     add(std::move(obj));
 }
@@ -525,7 +529,7 @@ QPDFParser::addScalar(Args&&... args)
         max_bad_count = 0;
         return;
     }
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = QPDFObject::create_in<T>(arena, std::forward<Args>(args)...);
     obj->setDescription(context, description, input.getLastOffset());
     add(std::move(obj));
 }
@@ -534,7 +538,7 @@ template <typename T, typename... Args>
 QPDFObjectHandle
 QPDFParser::withDescription(Args&&... args)
 {
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = QPDFObject::create_in<T>(arena, std::forward<Args>(args)...);
     obj->setDescription(context, description, start);
     return {obj};
 }
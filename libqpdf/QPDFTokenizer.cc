@@ -11,10 +11,16 @@
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
 
+#include <bit>
 #include <cstdlib>
 #include <cstring>
 #include <stdexcept>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define QPDF_TOKENIZER_SSE2
+# include <emmintrin.h>
+#endif
+
 using namespace qpdf;
 
 using Token = QPDFTokenizer::Token;
@@ -29,6 +35,121 @@ is_delimiter(char ch)
         ch == '\v' || ch == '\f' || ch == 0);
 }
 
+// The following functions return the length of the longest prefix of a buffer for which each
+// character is one of Chars (if In is true) or none of Chars (if In is false). They are used to
+// consume runs of characters that don't change the state of the tokenizer, such as the characters
+// of a name or the body of a string, without presenting them to the tokenizer one at a time.
+template <bool In, char... Chars>
+static inline size_t
+span(std::string_view buf)
+{
+    auto p = buf.data();
+    size_t n = buf.size();
+    size_t i = 0;
+#ifdef QPDF_TOKENIZER_SSE2
+    for (; i + 16 <= n; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + i));
+        auto matches = _mm_setzero_si128();
+        ((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(v, _mm_set1_epi8(Chars)))), ...);
+        unsigned int mask = unsigned(_mm_movemask_epi8(matches));
+        if constexpr (In) {
+            mask = ~mask & 0xffffU;
+        }
+        if (mask) {
+            return i + size_t(std::countr_zero(mask));
+        }
+    }
+#endif
+    while (i < n && ((p[i] == Chars) || ...) == In) {
+        ++i;
+    }
+    return i;
+}
+
+static inline size_t
+span_space(std::string_view buf)
+{
+    return span<true, ' ', '\n', '\r', '\t', '\f', '\v', '\0'>(buf);
+}
+
+static inline size_t
+span_regular(std::string_view buf)
+{
+    return span<
+        false,
+        ' ',
+        '\n',
+        '\r',
+        '\t',
+        '\f',
+        '\v',
+        '\0',
+        '/',
+        '(',
+        ')',
+        '{',
+        '}',
+        '<',
+        '>',
+        '[',
+        ']',
+        '%'>(buf);
+}
+
+static inline size_t
+span_name(std::string_view buf)
+{
+    // Like span_regular, but also stop at # so that escaped characters are handled by inName.
+    return span<
+        false,
+        ' ',
+        '\n',
+        '\r',
+        '\t',
+        '\f',
+        '\v',
+        '\0',
+        '/',
+        '(',
+        ')',
+        '{',
+        '}',
+        '<',
+        '>',
+        '[',
+        ']',
+        '%',
+        '#'>(buf);
+}
+
+static inline size_t
+span_hex(std::string_view buf)
+{
+    auto p = buf.data();
+    size_t n = buf.size();
+    size_t i = 0;
+#ifdef QPDF_TOKENIZER_SSE2
+    for (; i + 16 <= n; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + i));
+        // Characters with the high bit set compare as negative and are never hex digits.
+        auto digit = _mm_and_si128(
+            _mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        auto letter = _mm_and_si128(
+            _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        unsigned int mask = ~unsigned(_mm_movemask_epi8(_mm_or_si128(digit, letter))) & 0xffffU;
+        if (mask) {
+            return i + size_t(std::countr_zero(mask));
+        }
+    }
+#endif
+    while (i < n && util::is_hex_digit(p[i])) {
+        ++i;
+    }
+    return i;
+}
+
 namespace
 {
     class QPDFWordTokenFinder: public InputSource::Finder
@@ -978,17 +1099,188 @@ Tokenizer::readToken(InputSource& input, std::string const& context, bool allow_
     return token;
 }
 
+size_t
+Tokenizer::consumeRun(std::string_view buf)
+{
+    // Consume the longest prefix of buf that would leave the tokenizer in its current state if the
+    // characters were presented one at a time, and update val accordingly. The caller takes care of
+    // raw_val and the offset. Return the number of characters consumed.
+    size_t n = 0;
+    switch (state) {
+    case st_before_token:
+        // If include_ignorable is true, the first white space character changes the state.
+        return include_ignorable ? 0 : span_space(buf);
+
+    case st_in_space:
+        return span_space(buf);
+
+    case st_in_comment:
+        return span<false, '\r', '\n'>(buf);
+
+    case st_literal:
+        return span_regular(buf);
+
+    case st_name:
+        n = span_name(buf);
+        val.append(buf.data(), n);
+        return n;
+
+    case st_in_string:
+        n = span<false, '\\', '(', ')', '\r'>(buf);
+        val.append(buf.data(), n);
+        return n;
+
+    case st_in_hexstring:
+        n = span_hex(buf) & ~size_t(1);
+        for (size_t i = 0; i < n; i += 2) {
+            val += char((util::hex_decode_char(buf[i]) << 4) | util::hex_decode_char(buf[i + 1]));
+        }
+        return n;
+
+    default:
+        return 0;
+    }
+}
+
+namespace
+{
+    // Adapters giving Tokenizer::scanToken access to the characters of an input source. ReadSource
+    // works with any input source using its internal buffer. ReadMemory works directly on the data
+    // of a memory-backed input source and avoids virtual calls and copying of data.
+    class ReadSource
+    {
+      public:
+        ReadSource(InputSource& input) :
+            input(input)
+        {
+        }
+
+        qpdf_offset_t
+        start()
+        {
+            return input.fastTell();
+        }
+
+        std::string_view
+        buffered() const
+        {
+            return input.fastBuffered();
+        }
+
+        void
+        skip(size_t count)
+        {
+            input.fastSkip(count);
+        }
+
+        bool
+        read(char& ch)
+        {
+            return input.fastRead(ch);
+        }
+
+        void
+        finish(bool back)
+        {
+            input.fastUnread(back);
+        }
+
+        InputSource& input;
+    };
+
+    class ReadMemory
+    {
+      public:
+        ReadMemory(is::OffsetBuffer& input) :
+            input(input)
+        {
+        }
+
+        qpdf_offset_t
+        start()
+        {
+            return input.tell();
+        }
+
+        std::string_view
+        buffered() const
+        {
+            return input.remaining();
+        }
+
+        void
+        skip(size_t count)
+        {
+            input.advance(count);
+        }
+
+        bool
+        read(char& ch)
+        {
+            auto data = input.remaining();
+            if (data.empty()) {
+                // Let the input source update its last offset as it would at EOF.
+                return input.read(&ch, 1) != 0;
+            }
+            ch = data.front();
+            input.advance(1);
+            return true;
+        }
+
+        void
+        finish(bool back)
+        {
+            if (back) {
+                input.unreadCh('\0');
+            }
+            input.setLastOffset(input.tell());
+        }
+
+        is::OffsetBuffer& input;
+    };
+} // namespace
+
 bool
 Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_len)
+{
+    ReadSource reader(input);
+    return scanToken(reader, max_len);
+}
+
+bool
+Tokenizer::nextToken(is::OffsetBuffer& input, std::string const& context, size_t max_len)
+{
+    ReadMemory reader(input);
+    return scanToken(reader, max_len);
+}
+
+template <typename Reader>
+bool
+Tokenizer::scanToken(Reader& reader, size_t max_len)
 {
     if (state != st_inline_image) {
         reset();
     }
-    qpdf_offset_t offset = input.fastTell();
+    qpdf_offset_t offset = reader.start();
 
     while (state != st_token_ready) {
+        auto buf = reader.buffered();
+        if (max_len && in_token) {
+            // Leave the last character before max_len to the slow path so it can block the token.
+            buf = buf.substr(0, raw_val.length() + 1 < max_len ? max_len - 1 - raw_val.length() : 0);
+        }
+        if (auto n = consumeRun(buf)) {
+            reader.skip(n);
+            if (before_token) {
+                offset += qpdf_offset_t(n);
+            }
+            if (in_token) {
+                raw_val.append(buf.data(), n);
+            }
+            continue;
+        }
         char ch;
-        if (!input.fastRead(ch)) {
+        if (!reader.read(ch)) {
             presentEOF();
 
             if ((type == tt::tt_eof) && (!allow_eof)) {
@@ -996,7 +1288,7 @@ Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_
                 // case is not exercised.
                 type = tt::tt_bad;
                 error_message = "unexpected EOF";
-                offset = input.getLastOffset();
+                offset = reader.input.getLastOffset();
             }
         } else {
             handleCharacter(ch);
@@ -1016,10 +1308,10 @@ Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_
         }
     }
 
-    input.fastUnread(!in_token && !before_token);
+    reader.finish(!in_token && !before_token);
 
     if (type != tt::tt_eof) {
-        input.setLastOffset(offset);
+        reader.input.setLastOffset(offset);
     }
 
     return error_message.empty();
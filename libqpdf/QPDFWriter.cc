@@ -6,15 +6,19 @@
 
 #include <qpdf/MD5.hh>
 #include <qpdf/Pl_AES_PDF.hh>
+#include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_Flate.hh>
+#include <qpdf/Pl_Function.hh>
 #include <qpdf/Pl_MD5.hh>
 #include <qpdf/Pl_PNGFilter.hh>
 #include <qpdf/Pl_RC4.hh>
+#include <qpdf/Pl_SpillBuffer.hh>
 #include <qpdf/Pl_StdioFile.hh>
 #include <qpdf/Pl_String.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
 #include <qpdf/QPDFObject_private.hh>
+#include <qpdf/QPDFSystemError.hh>
 #include <qpdf/QPDF_private.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
@@ -22,12 +26,31 @@
 #include <qpdf/Util.hh>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <cstdlib>
 #include <stdexcept>
 
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
 using namespace std::literals;
 using namespace qpdf;
 
+static std::string
+deflate_data(std::string const& data)
+{
+    std::string result;
+    pl::String out("compressed data", nullptr, result);
+    Pl_Flate flate("compress data", &out, Pl_Flate::a_deflate);
+    flate.writeString(data);
+    flate.finish();
+    return result;
+}
+
 QPDFWriter::ProgressReporter::~ProgressReporter() // NOLINT (modernize-use-equals-default)
 {
     // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
@@ -111,6 +134,22 @@ QPDFWriter::setOutputFile(char const* description, FILE* file, bool close_file)
     initializePipelineStack(p.get());
 }
 
+void
+QPDFWriter::syncOutputFile()
+{
+    if (fflush(m->file) != 0) {
+        throw QPDFSystemError("flush "s + m->filename, errno);
+    }
+#ifdef _WIN32
+    int status = _commit(_fileno(m->file));
+#else
+    int status = fsync(fileno(m->file));
+#endif
+    if (status != 0) {
+        throw QPDFSystemError("sync "s + m->filename, errno);
+    }
+}
+
 void
 QPDFWriter::setOutputMemory()
 {
@@ -190,6 +229,12 @@ QPDFWriter::setRecompressFlate(bool val)
     m->recompress_flate = val;
 }
 
+void
+QPDFWriter::setCompressionThreads(size_t n)
+{
+    m->compression_threads = n;
+}
+
 void
 QPDFWriter::setContentNormalization(bool val)
 {
@@ -326,6 +371,42 @@ QPDFWriter::setLinearizationPass1Filename(std::string const& filename)
     m->lin_pass1_filename = filename;
 }
 
+void
+QPDFWriter::setLinearizationObjectCache(bool val)
+{
+    m->linearization_object_cache = val;
+}
+
+void
+QPDFWriter::setBufferMemoryLimit(size_t bytes)
+{
+    m->buffer_memory_limit = bytes;
+}
+
+void
+QPDFWriter::setOutputBufferSize(size_t bytes)
+{
+    m->output_buffer_size = bytes;
+}
+
+void
+QPDFWriter::setSyncOutput(bool val)
+{
+    m->sync_output = val;
+}
+
+void
+QPDFWriter::setDeduplicateObjects(bool val)
+{
+    m->deduplicate_objects = val;
+}
+
+void
+QPDFWriter::setIncrementalUpdate(bool val)
+{
+    m->incremental = val;
+}
+
 void
 QPDFWriter::setPCLm(bool val)
 {
@@ -923,6 +1004,17 @@ QPDFWriter::activatePipelineStack(PipelinePopper& pp, std::string& str)
     activatePipelineStack(pp, false, &str, nullptr);
 }
 
+void
+QPDFWriter::activatePipelineStack(PipelinePopper& pp, Pl_SpillBuffer& buffer)
+{
+    // The buffer is owned by the caller, so it is not pushed onto the stack.
+    auto* c = new pl::Count(m->next_stack_id, &buffer);
+    pp.stack_id = m->next_stack_id;
+    m->pipeline_stack.emplace_back(c);
+    m->pipeline = c;
+    ++m->next_stack_id;
+}
+
 void
 QPDFWriter::activatePipelineStack(PipelinePopper& pp, std::unique_ptr<pl::Link> link)
 {
@@ -976,6 +1068,66 @@ QPDFWriter::PipelinePopper::~PipelinePopper()
     qw->m->pipeline = dynamic_cast<pl::Count*>(qw->m->pipeline_stack.back());
 }
 
+QPDFWriter::PhaseTimer::PhaseTimer(QPDFWriter* qw, char const* phase)
+{
+    if (qw->m->collect_statistics) {
+        this->qw = qw;
+        previous = qw->m->phase;
+        qw->switchPhase(phase);
+    }
+}
+
+QPDFWriter::PhaseTimer::~PhaseTimer()
+{
+    if (qw) {
+        qw->switchPhase(previous);
+    }
+}
+
+void
+QPDFWriter::switchPhase(char const* phase)
+{
+    // Charge the time since the last switch to the phase that was active.
+    auto wall = std::chrono::steady_clock::now();
+    auto cpu = std::clock();
+    if (m->phase) {
+        auto& stats = m->statistics.phases[m->phase];
+        stats.wall_time += std::chrono::duration<double>(wall - m->phase_wall_start).count();
+        stats.cpu_time += static_cast<double>(cpu - m->phase_cpu_start) / CLOCKS_PER_SEC;
+    }
+    m->phase = phase;
+    m->phase_wall_start = wall;
+    m->phase_cpu_start = cpu;
+}
+
+char const*
+QPDFWriter::streamDataPhase() const
+{
+    // The stream data is encrypted while it is written.
+    return m->encrypted && !m->cur_data_key.empty() ? "encrypt stream data" : "write stream data";
+}
+
+void
+QPDFWriter::countStream(QPDFObjectHandle stream, int flags, bool compress)
+{
+    auto filter = stream.getDict().getKey("/Filter");
+    auto& stats = m->statistics.filters[filter.null() ? "none" : filter.unparseResolved()];
+    ++stats.streams;
+    if (auto buffer = stream.as_stream().getStreamDataBuffer()) {
+        stats.bytes_in += buffer->getSize();
+    } else {
+        stats.bytes_in += stream.as_stream().getLength();
+    }
+    stats.bytes_out += m->cur_stream_length;
+    if (!(flags & f_filtered)) {
+        ++m->statistics.streams_passed_through;
+    } else if (compress) {
+        ++m->statistics.streams_recompressed;
+    } else {
+        ++m->statistics.streams_decoded;
+    }
+}
+
 void
 QPDFWriter::adjustAESStreamLength(size_t& length)
 {
@@ -1040,14 +1192,16 @@ QPDFWriter::computeDeterministicIDData()
 }
 
 int
-QPDFWriter::openObject(int objid)
+QPDFWriter::openObject(int objid, int gen)
 {
     if (objid == 0) {
         objid = m->next_objid++;
     }
     m->new_obj[objid].xref = QPDFXRefEntry(m->pipeline->getCount());
     writeString(std::to_string(objid));
-    writeString(" 0 obj\n");
+    writeString(" ");
+    writeString(std::to_string(gen));
+    writeString(" obj\n");
     return objid;
 }
 
@@ -1091,6 +1245,11 @@ QPDFWriter::enqueueObject(QPDFObjectHandle object)
                 "QPDF::copyForeignObject to add objects from another file.");
         }
 
+        if (m->incremental) {
+            // Only the objects that changed are written, and they keep their numbers.
+            return;
+        }
+
         if (m->qdf_mode && object.isStreamOfType("/XRef")) {
             // As a special case, do not output any extraneous XRef streams in QDF mode. Doing so
             // will confuse fix-qdf, which expects to see only one XRef stream at the end of the
@@ -1155,13 +1314,72 @@ QPDFWriter::unparseChild(QPDFObjectHandle child, int level, int flags)
         enqueueObject(child);
     }
     if (child.isIndirect()) {
-        writeString(std::to_string(m->obj[child].renumber));
-        writeString(" 0 R");
+        if (m->unparsed_references) {
+            m->unparsed_references->emplace_back(child.getObjGen(), m->obj[child].renumber);
+        }
+        if (m->incremental) {
+            writeString(child.getObjGen().unparse(' '));
+        } else {
+            writeString(std::to_string(m->obj[child].renumber));
+            writeString(" 0");
+        }
+        writeString(" R");
     } else {
         unparseObject(child, level, flags);
     }
 }
 
+void
+QPDFWriter::unparseObjectCached(QPDFObjectHandle object, int flags)
+{
+    // Unparse a non-stream indirect object, reusing the bytes written for it previously if the
+    // object hasn't changed and the objects it refers to still have the same numbers.
+    auto og = object.getObjGen();
+    if (!QPDF::Writer::unparsedObjectCache(m->pdf) || m->qdf_mode || !og.isIndirect() ||
+        og == m->root_og || object.isStream()) {
+        unparseObject(object, 0, flags);
+        return;
+    }
+    auto settings = std::to_string(flags) + (m->incremental ? " i " : " n ") +
+        (m->encrypt_use_aes ? "a " : "r ") + m->cur_data_key;
+    if (auto cached = QPDF::Writer::getUnparsedObject(m->pdf, og, settings)) {
+        // Enqueue the objects referenced by the object in the same order unparseObject would.
+        bool same = true;
+        for (auto const& [ref_og, renumber]: cached->references) {
+            auto ref = m->pdf.getObject(ref_og);
+            if (!ref.isIndirect()) {
+                same = false;
+                break;
+            }
+            if (!m->linearized) {
+                enqueueObject(ref);
+            }
+            if (m->obj[ref_og].renumber != renumber) {
+                same = false;
+            }
+        }
+        if (same) {
+            QTC::TC("qpdf", "QPDFWriter reuse unparsed object");
+            writeString(cached->data);
+            return;
+        }
+    }
+    QPDF::UnparsedObject unparsed;
+    unparsed.settings = std::move(settings);
+    m->unparsed_references = &unparsed.references;
+    m->unparsed_cacheable = true;
+    {
+        PipelinePopper pp_unparsed(this);
+        activatePipelineStack(pp_unparsed, unparsed.data);
+        unparseObject(object, 0, flags);
+    }
+    m->unparsed_references = nullptr;
+    writeString(unparsed.data);
+    if (m->unparsed_cacheable) {
+        QPDF::Writer::setUnparsedObject(m->pdf, og, std::move(unparsed));
+    }
+}
+
 void
 QPDFWriter::writeTrailer(
     trailer_e which, int size, bool xref_stream, qpdf_offset_t prev, int linearization_pass)
@@ -1198,6 +1416,14 @@ QPDFWriter::writeTrailer(
             }
             writeStringQDF("\n");
         }
+        if (which == t_normal && prev) {
+            // The trailer of an incremental update points to the previous cross-reference section.
+            writeStringQDF("  ");
+            writeStringNoQDF(" ");
+            writeString("/Prev ");
+            writeString(std::to_string(prev));
+            writeStringQDF("\n");
+        }
     }
 
     // Write ID
@@ -1249,8 +1475,11 @@ QPDFWriter::willFilterStream(
     QPDFObjectHandle stream,
     bool& compress_stream,  // out only
     bool& is_root_metadata, // out only
-    std::string* stream_data)
+    Pl_SpillBuffer* stream_data,
+    bool defer_compression,
+    bool* copy_raw)
 {
+    PhaseTimer timer(this, "filter streams");
     compress_stream = false;
     is_root_metadata = false;
 
@@ -1300,6 +1529,26 @@ QPDFWriter::willFilterStream(
         compress_stream = false;
     }
 
+    if (copy_raw && stream.as_stream().canCopyRawStreamData()) {
+        // If the data is not going to be filtered, either because no filtering was requested or
+        // because the stream's filters are not supported at the decode level, the caller copies it
+        // directly from the input file.
+        bool unfiltered = !filter;
+        if (filter) {
+            std::vector<std::shared_ptr<QPDFStreamFilter>> filters;
+            unfiltered = !stream.as_stream().filterable(
+                uncompress ? qpdf_dl_all : m->stream_decode_level, filters);
+        }
+        if (unfiltered) {
+            if (filter) {
+                stream.setFilterOnWrite(false);
+            }
+            compress_stream = false;
+            *copy_raw = true;
+            return false;
+        }
+    }
+
     bool filtered = false;
     for (bool first_attempt: {true, false}) {
         PipelinePopper pp_stream_data(this);
@@ -1313,7 +1562,8 @@ QPDFWriter::willFilterStream(
                 m->pipeline,
                 !filter ? 0
                         : ((normalize ? qpdf_ef_normalize : 0) |
-                           (compress_stream ? qpdf_ef_compress : 0)),
+                           (compress_stream ? qpdf_ef_compress : 0) |
+                           (compress_stream && defer_compression ? Stream::ef_filter_only : 0)),
                 !filter ? qpdf_dl_none : (uncompress ? qpdf_dl_all : m->stream_decode_level),
                 false,
                 first_attempt);
@@ -1345,6 +1595,47 @@ QPDFWriter::willFilterStream(
     return filtered;
 }
 
+void
+QPDFWriter::prepareStreams()
+{
+    // Retrieve the data of the streams among the next objects in the queue and start compressing
+    // it on the worker threads, keeping enough streams in progress to keep the workers busy.
+    // Retrieving and filtering stream data uses the QPDF object, so it is done on this thread.
+    auto max_pending = 2 * m->compression_pool->size();
+    m->prepare_front = std::max(m->prepare_front, m->object_queue_front);
+    while (m->prepared_streams.size() < max_pending &&
+           m->prepare_front < m->object_queue.size()) {
+        auto stream = m->object_queue.at(m->prepare_front++);
+        auto og = stream.getObjGen();
+        if (!stream.isStream() ||
+            (og.getGen() == 0 && m->object_stream_to_objects.contains(og.getObj()))) {
+            continue;
+        }
+        Members::PreparedStream prepared;
+        Pl_SpillBuffer data("stream data", m->buffer_memory_limit);
+        bool copy_raw = false;
+        prepared.filtered = willFilterStream(
+            stream, prepared.compress, prepared.is_metadata, &data, true, &copy_raw);
+        if (copy_raw) {
+            // There is nothing to compress; unparseObject copies the data from the input file.
+            continue;
+        }
+        if (data.spilled()) {
+            // The data is too large to be kept in memory, so leave the stream to be filtered again
+            // and written by unparseObject without a worker thread.
+            QTC::TC("qpdf", "QPDFWriter stream too large for worker thread");
+            continue;
+        }
+        prepared.data = data.getString();
+        if (prepared.compress) {
+            QTC::TC("qpdf", "QPDFWriter compress on worker thread");
+            prepared.compressed = m->compression_pool->submit(
+                [data = std::move(prepared.data)]() { return deflate_data(data); });
+        }
+        m->prepared_streams.emplace(og, std::move(prepared));
+    }
+}
+
 void
 QPDFWriter::unparseObject(
     QPDFObjectHandle object, int level, int flags, size_t stream_length, bool compress)
@@ -1366,6 +1657,10 @@ QPDFWriter::unparseObject(
         // Note: PDF spec 1.4 implementation note 121 states that Acrobat requires a space after the
         // [ in the /H key of the linearization parameter dictionary.  We'll do this unconditionally
         // for all arrays because it looks nicer and doesn't make the files that much bigger.
+        if (m->unparsed_references && level > 0 && object.getOwningQPDF() != &m->pdf) {
+            // Changes to direct objects that don't belong to this file can't be detected.
+            m->unparsed_cacheable = false;
+        }
         writeString("[");
         for (auto const& item: object.as_array()) {
             writeString(indent);
@@ -1375,6 +1670,10 @@ QPDFWriter::unparseObject(
         writeString(indent);
         writeString("]");
     } else if (tc == ::ot_dictionary) {
+        if (m->unparsed_references && level > 0 && object.getOwningQPDF() != &m->pdf) {
+            m->unparsed_cacheable = false;
+        }
+
         // Handle special cases for specific dictionaries.
 
         if (old_og == m->root_og) {
@@ -1561,25 +1860,56 @@ QPDFWriter::unparseObject(
         flags |= f_stream;
         bool compress_stream = false;
         bool is_metadata = false;
-        std::string stream_data;
-        if (willFilterStream(object, compress_stream, is_metadata, &stream_data)) {
+        bool copy_raw = false;
+        Pl_SpillBuffer stream_data("stream data", m->buffer_memory_limit);
+        if (auto it = m->prepared_streams.find(old_og); it != m->prepared_streams.end()) {
+            auto& prepared = it->second;
+            compress_stream = prepared.compress;
+            is_metadata = prepared.is_metadata;
+            if (prepared.filtered) {
+                flags |= f_filtered;
+            }
+            if (compress_stream) {
+                PhaseTimer timer(this, "wait for worker threads");
+                stream_data.assign(prepared.compressed.get());
+            } else {
+                stream_data.assign(std::move(prepared.data));
+            }
+            m->prepared_streams.erase(it);
+        } else if (willFilterStream(
+                       object, compress_stream, is_metadata, &stream_data, false, &copy_raw)) {
             flags |= f_filtered;
         }
         QPDFObjectHandle stream_dict = object.getDict();
 
-        m->cur_stream_length = stream_data.size();
+        m->cur_stream_length = copy_raw ? object.as_stream().getLength() : stream_data.size();
         if (is_metadata && m->encrypted && (!m->encrypt_metadata)) {
             // Don't encrypt stream data for the metadata stream
             m->cur_data_key.clear();
         }
         adjustAESStreamLength(m->cur_stream_length);
+        if (m->collect_statistics) {
+            countStream(object, flags, compress_stream);
+        }
         unparseObject(stream_dict, 0, flags, m->cur_stream_length, compress_stream);
-        char last_char = stream_data.empty() ? '\0' : stream_data.back();
+        char last_char = stream_data.back();
         writeString("\nstream\n");
         {
+            PhaseTimer timer(this, streamDataPhase());
             PipelinePopper pp_enc(this);
             pushEncryptionFilter(pp_enc);
-            writeString(stream_data);
+            if (copy_raw) {
+                // Copy the unmodified data straight from the input file without buffering it.
+                QTC::TC("qpdf", "QPDFWriter copy raw stream data");
+                Pl_Function last("last character", m->pipeline, [&last_char](auto buf, auto len) {
+                    if (len) {
+                        last_char = static_cast<char>(buf[len - 1]);
+                    }
+                });
+                object.as_stream().copyRawStreamData(&last);
+            } else {
+                stream_data.writeTo(*m->pipeline);
+            }
         }
 
         if (m->newline_before_endstream || (m->qdf_mode && last_char != '\n')) {
@@ -1647,26 +1977,17 @@ QPDFWriter::writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, int fi
     writeString("\n");
 }
 
-void
-QPDFWriter::writeObjectStream(QPDFObjectHandle object)
+qpdf_offset_t
+QPDFWriter::unparseObjectStream(int old_id, Pl_SpillBuffer& stream_data)
 {
-    // Note: object might be null if this is a place-holder for an object stream that we are
-    // generating from scratch.
-
-    QPDFObjGen old_og = object.getObjGen();
-    qpdf_assert_debug(old_og.getGen() == 0);
-    int old_id = old_og.getObj();
-    int new_stream_id = m->obj[old_og].renumber;
-
+    PhaseTimer timer(this, "object streams");
+    // Generate the uncompressed data of the object stream with the given original id into
+    // stream_data and return the value of /First. We have to do this in two passes so we can
+    // calculate offsets in the first pass.
+    int new_stream_id = m->obj[QPDFObjGen(old_id, 0)].renumber;
     std::vector<qpdf_offset_t> offsets;
-    qpdf_offset_t first = 0;
-
-    // Generate stream itself.  We have to do this in two passes so we can calculate offsets in the
-    // first pass.
-    std::string stream_buffer_pass1;
-    std::string stream_buffer_pass2;
+    Pl_SpillBuffer stream_buffer_pass1("object stream data", m->buffer_memory_limit);
     int first_obj = -1;
-    const bool compressed = m->compress_streams && !m->qdf_mode;
     {
         // Pass 1
         PipelinePopper pp_ostream_pass1(this);
@@ -1713,36 +2034,66 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
             m->new_obj[new_obj].xref = QPDFXRefEntry(new_stream_id, count);
         }
     }
+
+    // Adjust offsets to skip over comment before first object
+    qpdf_offset_t first = offsets.at(0);
+    for (auto& iter: offsets) {
+        iter -= first;
+    }
+
+    // Write the pairs of numbers followed by the objects.
+    stream_data.clear();
     {
         PipelinePopper pp_ostream(this);
-        // Adjust offsets to skip over comment before first object
-        first = offsets.at(0);
-        for (auto& iter: offsets) {
-            iter -= first;
-        }
+        activatePipelineStack(pp_ostream, stream_data);
+        writeObjectStreamOffsets(offsets, first_obj);
+    }
+    first += QIntC::to_offset(stream_data.size());
+    stream_buffer_pass1.writeTo(stream_data);
+    return first;
+}
 
-        // Take one pass at writing pairs of numbers so we can get their size information
-        {
-            PipelinePopper pp_discard(this);
-            activatePipelineStack(pp_discard, true);
-            writeObjectStreamOffsets(offsets, first_obj);
-            first += m->pipeline->getCount();
-        }
+void
+QPDFWriter::writeObjectStream(QPDFObjectHandle object)
+{
+    // Note: object might be null if this is a place-holder for an object stream that we are
+    // generating from scratch.
 
-        // Set up a stream to write the stream data into a buffer.
-        if (compressed) {
-            activatePipelineStack(
-                pp_ostream,
-                pl::create<Pl_Flate>(
-                    pl::create<pl::String>(stream_buffer_pass2), Pl_Flate::a_deflate));
-        } else {
-            activatePipelineStack(pp_ostream, stream_buffer_pass2);
-        }
-        writeObjectStreamOffsets(offsets, first_obj);
-        writeString(stream_buffer_pass1);
-        stream_buffer_pass1.clear();
-        stream_buffer_pass1.shrink_to_fit();
+    Pl_SpillBuffer stream_data("object stream data", m->buffer_memory_limit);
+    auto first = unparseObjectStream(object.getObjectID(), stream_data);
+    writeObjectStream(object, first, stream_data);
+}
+
+void
+QPDFWriter::writeObjectStream(
+    QPDFObjectHandle object, qpdf_offset_t first, Pl_SpillBuffer& stream_data)
+{
+    // Compress the uncompressed data of an object stream if needed and write the object stream.
+    if (!m->compress_streams || m->qdf_mode) {
+        writeObjectStreamData(object, first, stream_data);
+        return;
+    }
+    Pl_SpillBuffer compressed("compressed object stream data", m->buffer_memory_limit);
+    {
+        PhaseTimer timer(this, "object streams");
+        Pl_Flate flate("compress object stream", &compressed, Pl_Flate::a_deflate);
+        stream_data.writeTo(flate);
+        flate.finish();
     }
+    stream_data.clear();
+    writeObjectStreamData(object, first, compressed);
+}
+
+void
+QPDFWriter::writeObjectStreamData(
+    QPDFObjectHandle object, qpdf_offset_t first, Pl_SpillBuffer& stream_data)
+{
+    QPDFObjGen old_og = object.getObjGen();
+    qpdf_assert_debug(old_og.getGen() == 0);
+    int new_stream_id = m->obj[old_og].renumber;
+    size_t n = m->object_stream_to_objects[old_og.getObj()].size();
+    const bool compressed = m->compress_streams && !m->qdf_mode;
+    ++m->statistics.object_streams;
 
     // Write the object
     openObject(new_stream_id);
@@ -1751,14 +2102,14 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
     writeStringQDF("\n ");
     writeString(" /Type /ObjStm");
     writeStringQDF("\n ");
-    size_t length = stream_buffer_pass2.size();
+    size_t length = stream_data.size();
     adjustAESStreamLength(length);
     writeString(" /Length " + std::to_string(length));
     writeStringQDF("\n ");
     if (compressed) {
         writeString(" /Filter /FlateDecode");
     }
-    writeString(" /N " + std::to_string(offsets.size()));
+    writeString(" /N " + std::to_string(n));
     writeStringQDF("\n ");
     writeString(" /First " + std::to_string(first));
     if (!object.isNull()) {
@@ -1779,9 +2130,10 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
         QTC::TC("qpdf", "QPDFWriter encrypt object stream");
     }
     {
+        PhaseTimer timer(this, streamDataPhase());
         PipelinePopper pp_enc(this);
         pushEncryptionFilter(pp_enc);
-        writeString(stream_buffer_pass2);
+        stream_data.writeTo(*m->pipeline);
     }
     if (m->newline_before_endstream) {
         writeString("\n");
@@ -1802,6 +2154,8 @@ QPDFWriter::writeObject(QPDFObjectHandle object, int object_stream_index)
         return;
     }
 
+    PhaseTimer timer(this, "write objects");
+    ++m->statistics.objects;
     indicateProgress(false, false);
     auto new_id = m->obj[old_og].renumber;
     if (m->qdf_mode) {
@@ -1822,11 +2176,11 @@ QPDFWriter::writeObject(QPDFObjectHandle object, int object_stream_index)
         }
         openObject(new_id);
         setDataKey(new_id);
-        unparseObject(object, 0, 0);
+        unparseObjectCached(object, 0);
         m->cur_data_key.clear();
         closeObject(new_id);
     } else {
-        unparseObject(object, 0, f_in_ostream);
+        unparseObjectCached(object, f_in_ostream);
         writeString("\n");
     }
 
@@ -1842,6 +2196,110 @@ QPDFWriter::writeObject(QPDFObjectHandle object, int object_stream_index)
     }
 }
 
+void
+QPDFWriter::writeObjectWithThreads(QPDFObjectHandle object)
+{
+    // Object streams are unparsed on this thread, since unparsing determines the numbering of any
+    // objects they refer to that haven't been numbered yet, and compressed on a worker thread.
+    // While an object stream is being compressed, the objects that come after it are written to a
+    // buffer, which is copied to the output once the object stream has been written.
+    static constexpr size_t max_buffered = 4 << 20;
+    auto og = object.getObjGen();
+    if (og.getGen() == 0 && m->object_stream_to_objects.contains(og.getObj()) &&
+        m->compress_streams && !m->qdf_mode) {
+        Pl_SpillBuffer data("object stream data", m->buffer_memory_limit);
+        auto first = unparseObjectStream(og.getObj(), data);
+        if (data.spilled()) {
+            // The data is too large to be kept in memory, so compress it on this thread after
+            // writing the object streams that are in progress.
+            QTC::TC("qpdf", "QPDFWriter object stream too large for worker thread");
+            while (!m->pending_object_streams.empty()) {
+                flushObjectStream();
+            }
+            writeObjectStream(object, first, data);
+            return;
+        }
+        QTC::TC("qpdf", "QPDFWriter compress object stream on worker thread");
+        Members::PendingObjectStream pending;
+        pending.object = object;
+        pending.first = first;
+        pending.compressed = m->compression_pool->submit(
+            [data = data.getString()]() { return deflate_data(data); });
+        m->pending_object_streams.push_back(std::move(pending));
+    } else if (m->pending_object_streams.empty()) {
+        writeObject(object);
+    } else {
+        auto& pending = m->pending_object_streams.back();
+        QTC::TC(
+            "qpdf",
+            "QPDFWriter buffer object behind object stream",
+            pending.following.empty() ? 0 : 1);
+        writeObjectToBuffer(object, pending.following, pending.following_ids);
+    }
+
+    // Write out the oldest object streams, waiting for them if necessary, once too much is being
+    // held back. This doesn't depend on how far the worker threads have got, so objects are
+    // buffered in the same way on every run.
+    size_t buffered = 0;
+    for (auto const& pending: m->pending_object_streams) {
+        buffered += pending.following.size();
+    }
+    while (!m->pending_object_streams.empty() &&
+           (m->pending_object_streams.size() > 2 * m->compression_pool->size() ||
+            buffered > max_buffered)) {
+        buffered -= m->pending_object_streams.front().following.size();
+        flushObjectStream();
+    }
+}
+
+void
+QPDFWriter::flushObjectStream()
+{
+    auto pending = std::move(m->pending_object_streams.front());
+    m->pending_object_streams.pop_front();
+    Pl_SpillBuffer stream_data("compressed object stream data", 0);
+    {
+        PhaseTimer timer(this, "wait for worker threads");
+        stream_data.assign(pending.compressed.get());
+    }
+    writeObjectStreamData(pending.object, pending.first, stream_data);
+    rebaseObjectOffsets(pending.following_ids, m->pipeline->getCount());
+    writeString(pending.following);
+}
+
+void
+QPDFWriter::writeObjectToBuffer(
+    QPDFObjectHandle object, std::string& buffer, std::vector<int>& ids)
+{
+    // Append the object to buffer. The offsets of the object and its length object, whose new ids
+    // are appended to ids, are relative to the start of buffer, since the count of a pipeline that
+    // writes to a string is the size of the string.
+    {
+        PipelinePopper pp_buffer(this);
+        activatePipelineStack(pp_buffer, buffer);
+        writeObject(object);
+    }
+    auto og = object.getObjGen();
+    auto new_id = m->obj[og].renumber;
+    int n_ids = 1;
+    if (!m->direct_stream_lengths && object.isStream() &&
+        !(og.getGen() == 0 && m->object_stream_to_objects.contains(og.getObj()))) {
+        n_ids = 2;
+    }
+    for (int id = new_id; id < new_id + n_ids; ++id) {
+        ids.push_back(id);
+    }
+}
+
+void
+QPDFWriter::rebaseObjectOffsets(std::vector<int> const& ids, qpdf_offset_t delta)
+{
+    for (auto id: ids) {
+        auto& xref = m->new_obj[id].xref;
+        xref = QPDFXRefEntry(xref.getOffset() + delta);
+    }
+}
+
 std::string
 QPDFWriter::getOriginalID1()
 {
@@ -1964,6 +2422,7 @@ QPDFWriter::initializeSpecialStreams()
             m->contents_to_page_seq[c] = num;
             m->normalized_streams.insert(c);
         }
+        m->pdf.trimObjectCache();
     }
 }
 
@@ -2107,6 +2566,269 @@ QPDFWriter::prepareFileForWrite()
     }
 }
 
+namespace
+{
+    // Objects whose identity matters even if another object has the same contents.
+    bool
+    is_unique_object(QPDFObjectHandle const& object)
+    {
+        if (!object.isDictionary() || object.isStream()) {
+            return false;
+        }
+        if (object.hasKey("/Parent") || object.hasKey("/P")) {
+            // Page tree nodes, annotations, form fields, outline items, structure elements
+            return true;
+        }
+        static std::set<std::string> const types = {
+            "/Annot",
+            "/Bead",
+            "/Catalog",
+            "/OCG",
+            "/OCMD",
+            "/Outlines",
+            "/Page",
+            "/Pages",
+            "/Sig",
+            "/StructElem",
+            "/StructTreeRoot",
+            "/Thread"};
+        auto type = object.getKey("/Type");
+        return type.isName() && types.contains(type.getName());
+    }
+} // namespace
+
+void
+QPDFWriter::deduplicateObjects()
+{
+    // Replace references to indirect objects with references to an identical object. Objects are
+    // identical if their contents are the same after references to objects that have already been
+    // replaced are resolved, so this is repeated until nothing changes to catch objects such as
+    // fonts whose descriptors refer to identical font files. Stream dictionaries are compared first
+    // and the data of streams with identical dictionaries is hashed. Streams whose hashes match are
+    // compared byte for byte.
+    PhaseTimer timer(this, "deduplicate objects");
+
+    // Find all objects reachable from the trailer in a predictable order. The first of a set of
+    // identical objects is kept.
+    std::vector<QPDFObjectHandle> objects;
+    QPDFObjGen::set seen;
+    std::set<QPDFObjGen> unique;
+    {
+        std::vector<QPDFObjectHandle> queue{m->pdf.getTrailer()};
+        while (!queue.empty()) {
+            auto object = queue.back();
+            queue.pop_back();
+            if (object.isIndirect()) {
+                if (!seen.add(object.getObjGen())) {
+                    continue;
+                }
+                objects.emplace_back(object);
+                if (is_unique_object(object)) {
+                    unique.insert(object.getObjGen());
+                }
+            }
+            if (object.isStream()) {
+                object = object.getDict();
+            }
+            std::vector<QPDFObjectHandle> children;
+            if (object.isArray()) {
+                for (auto const& item: object.as_array()) {
+                    children.emplace_back(item);
+                }
+            } else if (object.isDictionary()) {
+                for (auto const& [key, value]: object.as_dictionary()) {
+                    if (!value.null()) {
+                        children.emplace_back(value);
+                    }
+                }
+            }
+            queue.insert(queue.end(), children.rbegin(), children.rend());
+        }
+    }
+    // The document catalog, information dictionary, and encryption dictionary are referenced from
+    // the trailer.
+    for (auto const& [key, value]: m->pdf.getTrailer().as_dictionary()) {
+        if (value.isIndirect()) {
+            unique.insert(value.getObjGen());
+        }
+    }
+    for (auto const& page: m->pdf.getAllPages()) {
+        auto annots = page.getKey("/Annots");
+        if (annots.isArray()) {
+            for (auto const& annot: annots.as_array()) {
+                if (annot.isIndirect()) {
+                    unique.insert(annot.getObjGen());
+                }
+            }
+        }
+    }
+
+    std::map<QPDFObjGen, QPDFObjGen> replacements;
+    auto resolve = [&replacements](QPDFObjGen og) {
+        for (auto it = replacements.find(og); it != replacements.end();
+             it = replacements.find(og)) {
+            og = it->second;
+        }
+        return og;
+    };
+
+    // Append a description of the contents of an object to key with references to other objects
+    // resolved.
+    std::function<void(QPDFObjectHandle const&, std::string&, bool)> describe;
+    describe = [&describe, &resolve](QPDFObjectHandle const& object, std::string& key, bool top) {
+        if (!top && object.isIndirect()) {
+            key += resolve(object.getObjGen()).unparse(' ');
+            key += " R";
+        } else if (object.isArray()) {
+            key += "[";
+            for (auto const& item: object.as_array()) {
+                describe(item, key, false);
+                key += " ";
+            }
+            key += "]";
+        } else if (object.isDictionary()) {
+            key += "<<";
+            for (auto const& [name, value]: object.as_dictionary()) {
+                if (!value.null()) {
+                    key += Name::normalize(name);
+                    key += " ";
+                    describe(value, key, false);
+                    key += " ";
+                }
+            }
+            key += ">>";
+        } else {
+            key += object.unparseResolved();
+        }
+    };
+
+    std::map<QPDFObjGen, std::string> digests;
+    auto digest = [&digests](QPDFObjectHandle& stream) -> std::string const& {
+        auto [it, inserted] = digests.try_emplace(stream.getObjGen());
+        if (inserted) {
+            Pl_Discard discard;
+            Pl_MD5 md5("deduplicate", &discard);
+            if (stream.pipeStreamData(&md5, nullptr, 0, qpdf_dl_none)) {
+                it->second = md5.getHexDigest();
+            }
+        }
+        return it->second;
+    };
+    auto same_data = [](QPDFObjectHandle& a, QPDFObjectHandle& b) {
+        auto a_data = a.getRawStreamData();
+        auto b_data = b.getRawStreamData();
+        return a_data->getSize() == b_data->getSize() &&
+            (a_data->getSize() == 0 ||
+             std::memcmp(a_data->getBuffer(), b_data->getBuffer(), a_data->getSize()) == 0);
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::map<std::string, std::vector<QPDFObjectHandle>> groups;
+        for (auto& object: objects) {
+            auto og = object.getObjGen();
+            if (unique.contains(og) || replacements.contains(og)) {
+                continue;
+            }
+            std::string key;
+            if (object.isStream()) {
+                if (object.isStreamOfType("/XRef") || object.isStreamOfType("/ObjStm")) {
+                    continue;
+                }
+                // The length is written by QPDFWriter and is the same for identical data.
+                auto dict = object.getDict().shallowCopy();
+                dict.removeKey("/Length");
+                key = "stream ";
+                describe(dict, key, true);
+            } else if (object.isArray() || object.isDictionary()) {
+                describe(object, key, true);
+            } else {
+                // Indirect scalars such as stream lengths are not worth merging.
+                continue;
+            }
+            groups[key].emplace_back(object);
+        }
+        for (auto& [key, group]: groups) {
+            if (group.size() < 2) {
+                continue;
+            }
+            if (!group.front().isStream()) {
+                for (auto it = group.begin() + 1; it != group.end(); ++it) {
+                    replacements[it->getObjGen()] = group.front().getObjGen();
+                }
+                m->statistics.objects_deduplicated += group.size() - 1;
+                changed = true;
+                continue;
+            }
+            // For each digest, the streams with different data that have that digest.
+            std::map<std::string, std::vector<QPDFObjectHandle>> kept;
+            for (auto& stream: group) {
+                auto const& hash = digest(stream);
+                if (hash.empty()) {
+                    continue;
+                }
+                auto& candidates = kept[hash];
+                bool found = false;
+                for (auto& candidate: candidates) {
+                    if (same_data(candidate, stream)) {
+                        replacements[stream.getObjGen()] = candidate.getObjGen();
+                        ++m->statistics.objects_deduplicated;
+                        changed = true;
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    candidates.emplace_back(stream);
+                }
+            }
+        }
+    }
+    if (replacements.empty()) {
+        return;
+    }
+    QTC::TC("qpdf", "QPDFWriter deduplicate objects");
+
+    // Change references in all objects that are still used.
+    std::function<void(QPDFObjectHandle)> replace;
+    auto replacement = [this, &resolve, &replacements, &replace](QPDFObjectHandle const& item) {
+        if (item.isIndirect()) {
+            if (replacements.contains(item.getObjGen())) {
+                return m->pdf.getObject(resolve(item.getObjGen()));
+            }
+        } else {
+            replace(item);
+        }
+        return QPDFObjectHandle();
+    };
+    replace = [&replacement](QPDFObjectHandle object) {
+        if (object.isStream()) {
+            object = object.getDict();
+        }
+        if (object.isArray()) {
+            int n = object.getArrayNItems();
+            for (int i = 0; i < n; ++i) {
+                if (auto item = replacement(object.getArrayItem(i))) {
+                    object.setArrayItem(i, item);
+                }
+            }
+        } else if (object.isDictionary()) {
+            for (auto const& key: object.getKeys()) {
+                if (auto item = replacement(object.getKey(key))) {
+                    object.replaceKey(key, item);
+                }
+            }
+        }
+    };
+    replace(m->pdf.getTrailer());
+    for (auto& object: objects) {
+        if (!replacements.contains(object.getObjGen())) {
+            replace(object);
+        }
+    }
+}
+
 void
 QPDFWriter::initializeTables(size_t extra)
 {
@@ -2125,6 +2847,20 @@ QPDFWriter::doWriteSetup()
 
     // Do preliminary setup
 
+    if (m->incremental) {
+        if (m->linearized || m->qdf_mode || m->pclm || m->encrypted) {
+            throw std::logic_error(
+                "QPDFWriter: incremental updates can't be combined with linearization, QDF mode, "
+                "PCLm, or encryption");
+        }
+        // Objects are written uncompressed with their original numbers. Merging objects would
+        // only add changed objects to the update.
+        m->preserve_encryption = false;
+        m->deduplicate_objects = false;
+        m->object_stream_mode = qpdf_o_disable;
+        m->forced_pdf_version.clear();
+    }
+
     if (m->linearized) {
         m->qdf_mode = false;
     }
@@ -2171,6 +2907,12 @@ QPDFWriter::doWriteSetup()
         }
     }
 
+    if (m->deduplicate_objects) {
+        // This must be done before object streams are generated since duplicates are no longer
+        // referenced afterwards.
+        deduplicateObjects();
+    }
+
     if (m->qdf_mode || m->normalize_content || m->stream_decode_level) {
         initializeSpecialStreams();
     }
@@ -2254,22 +2996,38 @@ QPDFWriter::doWriteSetup()
 void
 QPDFWriter::write()
 {
-    doWriteSetup();
+    PhaseTimer timer(this, "write");
+    if (m->output_buffer_size) {
+        // m->pipeline is still the bottom of the pipeline stack.
+        m->pipeline->buffer(m->output_buffer_size);
+    }
+    {
+        PhaseTimer setup_timer(this, "setup");
+        doWriteSetup();
+        if (!m->incremental) {
+            prepareFileForWrite();
+        }
+    }
 
     // Set up progress reporting. For linearized files, we write two passes. events_expected is an
     // approximation, but it's good enough for progress reporting, which is mostly a guess anyway.
-    m->events_expected = QIntC::to_int(m->pdf.getObjectCount() * (m->linearized ? 2 : 1));
 
-    prepareFileForWrite();
+    m->events_expected = QIntC::to_int(m->pdf.getObjectCount() * (m->linearized ? 2 : 1));
 
     if (m->linearized) {
         writeLinearized();
+    } else if (m->incremental) {
+        writeIncremental();
     } else {
         writeStandard();
     }
 
     m->pipeline->finish();
+    m->statistics.bytes_written = QIntC::to_size(m->pipeline->getCount());
     if (m->close_file) {
+        if (m->sync_output) {
+            syncOutputFile();
+        }
         fclose(m->file);
     }
     m->file = nullptr;
@@ -2303,6 +3061,7 @@ QPDFWriter::getWrittenXRefTable()
 void
 QPDFWriter::enqueuePart(std::vector<QPDFObjectHandle>& part)
 {
+    PhaseTimer timer(this, "enqueue objects");
     for (auto const& oh: part) {
         enqueueObject(oh);
     }
@@ -2354,6 +3113,7 @@ QPDFWriter::writeHeader()
 void
 QPDFWriter::writeHintStream(int hint_id)
 {
+    PhaseTimer timer(this, "hint stream");
     std::string hint_buffer;
     int S = 0;
     int O = 0;
@@ -2418,6 +3178,7 @@ QPDFWriter::writeXRefTable(
     qpdf_offset_t hint_length,
     int linearization_pass)
 {
+    PhaseTimer timer(this, "write xref");
     writeString("xref\n");
     writeString(std::to_string(first));
     writeString(" ");
@@ -2470,6 +3231,7 @@ QPDFWriter::writeXRefStream(
     bool skip_compression,
     int linearization_pass)
 {
+    PhaseTimer timer(this, "write xref");
     qpdf_offset_t xref_offset = m->pipeline->getCount();
     qpdf_offset_t space_before_zero = xref_offset - 1;
 
@@ -2596,14 +3358,16 @@ QPDFWriter::writeLinearized()
         return result;
     };
 
-    QPDF::Writer::optimize(m->pdf, m->obj, skip_stream_parameters);
-
     std::vector<QPDFObjectHandle> part4;
     std::vector<QPDFObjectHandle> part6;
     std::vector<QPDFObjectHandle> part7;
     std::vector<QPDFObjectHandle> part8;
     std::vector<QPDFObjectHandle> part9;
-    QPDF::Writer::getLinearizedParts(m->pdf, m->obj, part4, part6, part7, part8, part9);
+    {
+        PhaseTimer timer(this, "linearization analysis");
+        QPDF::Writer::optimize(m->pdf, m->obj, skip_stream_parameters);
+        QPDF::Writer::getLinearizedParts(m->pdf, m->obj, part4, part6, part7, part8, part9);
+    }
 
     // Object number sequence:
     //
@@ -2700,6 +3464,9 @@ QPDFWriter::writeLinearized()
 
     qpdf_offset_t hint_length = 0;
     std::string hint_buffer;
+    std::vector<Members::CachedObject> object_cache;
+    // Objects are written in both passes, so only the statistics of the first pass are kept.
+    Statistics pass1_statistics;
 
     // Write file in two passes.  Part numbers refer to PDF spec 1.4.
 
@@ -2830,11 +3597,33 @@ QPDFWriter::writeLinearized()
 
         // Parts 4 through 9
 
-        for (auto const& cur_object: m->object_queue) {
+        for (size_t i = 0; i < m->object_queue.size(); ++i) {
+            auto const& cur_object = m->object_queue.at(i);
             if (cur_object.getObjectID() == part6_end_marker) {
                 first_half_max_obj_offset = m->pipeline->getCount();
             }
-            writeObject(cur_object);
+            if (!m->linearization_object_cache) {
+                writeObject(cur_object);
+            } else if (pass == 1) {
+                // Keep the bytes of the object so that pass 2 can write them again without
+                // unparsing or compressing anything.
+                auto& cached = object_cache.emplace_back();
+                int events_before = m->events_seen;
+                writeObjectToBuffer(cur_object, cached.data, cached.ids);
+                cached.offset = m->pipeline->getCount();
+                cached.events = m->events_seen - events_before;
+                rebaseObjectOffsets(cached.ids, cached.offset);
+                writeString(cached.data);
+            } else {
+                // The objects are the same as in pass 1, but they may have moved.
+                QTC::TC("qpdf", "QPDFWriter linearize from object cache");
+                auto const& cached = object_cache.at(i);
+                rebaseObjectOffsets(cached.ids, m->pipeline->getCount() - cached.offset);
+                writeString(cached.data);
+                for (int j = 0; j < cached.events; ++j) {
+                    indicateProgress(false, false);
+                }
+            }
             if (cur_object.getObjectID() == part4_end_marker) {
                 if (m->encrypted) {
                     writeEncryptionDictionary();
@@ -2911,6 +3700,7 @@ QPDFWriter::writeLinearized()
             // Close first pass pipeline
             file_size = m->pipeline->getCount();
             pp_pass1 = nullptr;
+            pass1_statistics = m->statistics;
 
             // Save hint offset since it will be set to zero by calling openObject.
             qpdf_offset_t hint_offset1 = m->new_obj[hint_id].xref.getOffset();
@@ -2943,6 +3733,8 @@ QPDFWriter::writeLinearized()
             }
         }
     }
+    pass1_statistics.phases = std::move(m->statistics.phases);
+    m->statistics = std::move(pass1_statistics);
 }
 
 void
@@ -3033,6 +3825,47 @@ QPDFWriter::registerProgressReporter(std::shared_ptr<ProgressReporter> pr)
     m->progress_reporter = pr;
 }
 
+void
+QPDFWriter::setCollectStatistics(bool val)
+{
+    m->collect_statistics = val;
+}
+
+QPDFWriter::Statistics const&
+QPDFWriter::getStatistics() const
+{
+    return m->statistics;
+}
+
+JSON
+QPDFWriter::Statistics::getJSON() const
+{
+    auto count = [](size_t n) { return JSON::makeInt(QIntC::to_longlong(n)); };
+    auto j = JSON::makeDictionary();
+    j.addDictionaryMember("bytesWritten", count(bytes_written));
+    j.addDictionaryMember("objects", count(objects));
+    j.addDictionaryMember("objectStreams", count(object_streams));
+    j.addDictionaryMember("objectsDeduplicated", count(objects_deduplicated));
+    auto j_streams = j.addDictionaryMember("streams", JSON::makeDictionary());
+    j_streams.addDictionaryMember("recompressed", count(streams_recompressed));
+    j_streams.addDictionaryMember("decoded", count(streams_decoded));
+    j_streams.addDictionaryMember("passedThrough", count(streams_passed_through));
+    auto j_filters = j.addDictionaryMember("filters", JSON::makeDictionary());
+    for (auto const& [name, filter]: filters) {
+        auto j_filter = j_filters.addDictionaryMember(name, JSON::makeDictionary());
+        j_filter.addDictionaryMember("streams", count(filter.streams));
+        j_filter.addDictionaryMember("bytesIn", count(filter.bytes_in));
+        j_filter.addDictionaryMember("bytesOut", count(filter.bytes_out));
+    }
+    auto j_phases = j.addDictionaryMember("phases", JSON::makeDictionary());
+    for (auto const& [name, phase]: phases) {
+        auto j_phase = j_phases.addDictionaryMember(name, JSON::makeDictionary());
+        j_phase.addDictionaryMember("wallTime", JSON::makeReal(phase.wall_time));
+        j_phase.addDictionaryMember("cpuTime", JSON::makeReal(phase.cpu_time));
+    }
+    return j;
+}
+
 void
 QPDFWriter::writeStandard()
 {
@@ -3046,17 +3879,35 @@ QPDFWriter::writeStandard()
     writeHeader();
     writeString(m->extra_header_text);
 
-    if (m->pclm) {
-        enqueueObjectsPCLm();
-    } else {
-        enqueueObjectsStandard();
+    {
+        PhaseTimer timer(this, "enqueue objects");
+        if (m->pclm) {
+            enqueueObjectsPCLm();
+        } else {
+            enqueueObjectsStandard();
+        }
+    }
+
+    if (m->compression_threads != 1 && m->compress_streams) {
+        m->compression_pool = std::make_unique<ThreadPool>(m->compression_threads);
     }
 
     // Now start walking queue, outputting each object.
     while (m->object_queue_front < m->object_queue.size()) {
+        if (m->compression_pool) {
+            prepareStreams();
+        }
         QPDFObjectHandle cur_object = m->object_queue.at(m->object_queue_front);
         ++m->object_queue_front;
-        writeObject(cur_object);
+        if (m->compression_pool) {
+            writeObjectWithThreads(cur_object);
+        } else {
+            writeObject(cur_object);
+        }
+        m->pdf.trimObjectCache();
+    }
+    while (!m->pending_object_streams.empty()) {
+        flushObjectStream();
     }
 
     // Write out the encryption dictionary, if any
@@ -3086,3 +3937,147 @@ QPDFWriter::writeStandard()
             m->object_stream_to_objects.empty() ? 0 : 1);
     }
 }
+
+void
+QPDFWriter::writeIncremental()
+{
+    auto pp_md5 = PipelinePopper(this);
+    if (m->deterministic_id) {
+        pushMD5Pipeline(pp_md5);
+    }
+
+    // Copy the original file unchanged. The update has to start on a new line.
+    char last_char = '\n';
+    qpdf_offset_t prev = 0;
+    {
+        PhaseTimer timer(this, "copy input file");
+        Pl_Function last("last character", m->pipeline, [&last_char](auto buf, auto len) {
+            if (len) {
+                last_char = static_cast<char>(buf[len - 1]);
+            }
+        });
+        prev = QPDF::Writer::copyInputFile(m->pdf, &last);
+    }
+    if (last_char != '\n' && last_char != '\r') {
+        writeString("\n");
+    }
+
+    std::vector<QPDFObjGen> objects;
+    {
+        PhaseTimer timer(this, "find changed objects");
+        objects = QPDF::Writer::getChangedObjects(m->pdf);
+    }
+    m->events_expected = QIntC::to_int(objects.size());
+    for (auto const& og: objects) {
+        PhaseTimer timer(this, "write objects");
+        ++m->statistics.objects;
+        indicateProgress(false, false);
+        openObject(og.getObj(), og.getGen());
+        unparseObject(m->pdf.getObject(og), 0, 0);
+        closeObject(og.getObj());
+    }
+
+    // Use the same kind of cross-reference section as the original file.
+    bool xref_stream = m->pdf.getTrailer().getKey("/Type").isNameAndEquals("/XRef");
+    qpdf_offset_t xref_offset = writeIncrementalXRef(objects, prev, xref_stream);
+    writeString("startxref\n");
+    writeString(std::to_string(xref_offset));
+    writeString("\n%%EOF\n");
+}
+
+qpdf_offset_t
+QPDFWriter::writeIncrementalXRef(
+    std::vector<QPDFObjGen> const& objects, qpdf_offset_t prev, bool xref_stream)
+{
+    PhaseTimer timer(this, "write xref");
+    int size = 0;
+    m->pdf.getTrailer().getKey("/Size").getValueAsInt(size);
+    if (!objects.empty()) {
+        size = std::max(size, objects.back().getObj() + 1);
+    }
+    qpdf_offset_t xref_offset = m->pipeline->getCount();
+    auto entries = objects;
+    int xref_id = 0;
+    if (xref_stream) {
+        // The cross-reference stream is a new object, which is included in its own section.
+        xref_id = size++;
+        entries.emplace_back(xref_id, 0);
+        m->new_obj[xref_id].xref = QPDFXRefEntry(xref_offset);
+    }
+
+    // Only the written objects are listed, in subsections of consecutive object numbers.
+    std::vector<std::pair<int, int>> subsections;
+    int max_gen = 0;
+    for (auto const& og: entries) {
+        if (!subsections.empty() &&
+            subsections.back().first + subsections.back().second == og.getObj()) {
+            ++subsections.back().second;
+        } else {
+            subsections.emplace_back(og.getObj(), 1);
+        }
+        max_gen = std::max(max_gen, og.getGen());
+    }
+
+    if (!xref_stream) {
+        writeString("xref\n");
+        auto entry = entries.begin();
+        for (auto const& [first, count]: subsections) {
+            writeString(std::to_string(first));
+            writeString(" ");
+            writeString(std::to_string(count));
+            writeString("\n");
+            for (int i = 0; i < count; ++i, ++entry) {
+                writeString(QUtil::int_to_string(m->new_obj[entry->getObj()].xref.getOffset(), 10));
+                writeString(" ");
+                writeString(QUtil::int_to_string(entry->getGen(), 5));
+                writeString(" n \n");
+            }
+        }
+        writeTrailer(t_normal, size, false, prev, 0);
+        writeString("\n");
+        return xref_offset;
+    }
+
+    unsigned int f1_size = bytesNeeded(xref_offset);
+    unsigned int f2_size = bytesNeeded(max_gen);
+    unsigned int esize = 1 + f1_size + f2_size;
+    std::string xref_data;
+    const bool compressed = m->compress_streams;
+    {
+        PipelinePopper pp_xref(this);
+        if (compressed) {
+            activatePipelineStack(
+                pp_xref,
+                pl::create<Pl_PNGFilter>(
+                    pl::create<Pl_Flate>(pl::create<pl::String>(xref_data), Pl_Flate::a_deflate),
+                    Pl_PNGFilter::a_encode,
+                    esize));
+        } else {
+            activatePipelineStack(pp_xref, xref_data);
+        }
+        for (auto const& og: entries) {
+            writeBinary(1, 1);
+            writeBinary(QIntC::to_ulonglong(m->new_obj[og.getObj()].xref.getOffset()), f1_size);
+            writeBinary(QIntC::to_ulonglong(og.getGen()), f2_size);
+        }
+    }
+
+    openObject(xref_id);
+    writeString("<< /Type /XRef /Length " + std::to_string(xref_data.size()));
+    if (compressed) {
+        writeString(" /Filter /FlateDecode");
+        writeString(" /DecodeParms << /Columns " + std::to_string(esize) + " /Predictor 12 >>");
+    }
+    writeString(" /W [ 1 " + std::to_string(f1_size) + " " + std::to_string(f2_size) + " ]");
+    writeString(" /Index [");
+    for (auto const& [first, count]: subsections) {
+        writeString(" " + std::to_string(first) + " " + std::to_string(count));
+    }
+    writeString(" ]");
+    writeTrailer(t_normal, size, true, prev, 0);
+    writeString("\nstream\n");
+    writeString(xref_data);
+    writeString("\nendstream");
+    closeObject(xref_id);
+    return xref_offset;
+}
@@ -189,6 +189,7 @@ Array::setAt(int at, QPDFObjectHandle const& oh)
     }
     auto a = array();
     checkOwnership(oh);
+    obj->modified();
     if (a->sp) {
         a->sp->elements[at] = oh;
     } else {
@@ -201,6 +202,7 @@ void
 Array::setFromVector(std::vector<QPDFObjectHandle> const& v)
 {
     auto a = array();
+    obj->modified();
     a->elements.resize(0);
     a->elements.reserve(v.size());
     for (auto const& item: v) {
@@ -221,6 +223,7 @@ Array::insert(int at, QPDFObjectHandle const& item)
         push_back(item);
     } else {
         checkOwnership(item);
+        obj->modified();
         if (a->sp) {
             auto iter = a->sp->elements.crbegin();
             while (iter != a->sp->elements.crend()) {
@@ -247,6 +250,7 @@ Array::push_back(QPDFObjectHandle const& item)
 {
     auto a = array();
     checkOwnership(item);
+    obj->modified();
     if (a->sp) {
         a->sp->elements[(a->sp->size)++] = item;
     } else {
@@ -261,6 +265,7 @@ Array::erase(int at)
     if (at < 0 || at >= size()) {
         return false;
     }
+    obj->modified();
     if (a->sp) {
         auto end = a->sp->elements.end();
         if (auto iter = a->sp->elements.lower_bound(at); iter != end) {
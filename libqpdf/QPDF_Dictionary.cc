@@ -20,7 +20,8 @@ bool
 BaseDictionary::hasKey(std::string const& key) const
 {
     auto d = dict();
-    return d->items.contains(key) && !d->items[key].null();
+    auto item = d->items.find(key);
+    return item != d->items.end() && !item->second.null();
 }
 
 QPDFObjectHandle
@@ -50,23 +51,26 @@ BaseDictionary::getKeys()
     return result;
 }
 
-std::map<std::string, QPDFObjectHandle> const&
+std::map<std::string, QPDFObjectHandle>
 BaseDictionary::getAsMap() const
 {
-    return dict()->items;
+    return dict()->items.as_map<std::map<std::string, QPDFObjectHandle>>();
 }
 
 void
 BaseDictionary::removeKey(std::string const& key)
 {
     // no-op if key does not exist
-    dict()->items.erase(key);
+    auto d = dict();
+    obj->modified();
+    d->items.erase(key);
 }
 
 void
 BaseDictionary::replaceKey(std::string const& key, QPDFObjectHandle value)
 {
     auto d = dict();
+    obj->modified();
     if (value.isNull() && !value.isIndirect()) {
         // The PDF spec doesn't distinguish between keys with null values and missing keys.
         // Allow indirect nulls which are equivalent to a dangling reference, which is
@@ -353,6 +353,22 @@ Stream::getRawStreamData()
     return buf.getBufferSharedPointer();
 }
 
+bool
+Stream::canCopyRawStreamData() const
+{
+    auto s = stream();
+    return !s->stream_data && !s->stream_provider && s->token_filters.empty() &&
+        obj->getParsedOffset() != 0 &&
+        QPDF::Pipe::canCopyStreamData(obj->getQPDF(), obj->getParsedOffset(), s->length);
+}
+
+void
+Stream::copyRawStreamData(Pipeline* p) const
+{
+    QTC::TC("qpdf", "QPDF_Stream copy raw stream data");
+    QPDF::Pipe::copyStreamData(obj->getQPDF(), obj->getParsedOffset(), stream()->length, p);
+}
+
 bool
 Stream::isRootMetadata() const
 {
@@ -366,7 +382,8 @@ Stream::isRootMetadata() const
 bool
 Stream::filterable(
     qpdf_stream_decode_level_e decode_level,
-    std::vector<std::shared_ptr<QPDFStreamFilter>>& filters)
+    std::vector<std::shared_ptr<QPDFStreamFilter>>& filters,
+    bool suppress_warnings)
 {
     auto s = stream();
     // Check filters
@@ -388,7 +405,9 @@ Stream::filterable(
         // Potentially multiple filters
         for (auto const& item: array) {
             if (!item.isName()) {
-                warn("stream filter type is not name or array");
+                if (!suppress_warnings) {
+                    warn("stream filter type is not name or array");
+                }
                 return false;
             }
             auto ff = s->filter_factory(item.getName());
@@ -399,7 +418,9 @@ Stream::filterable(
             filters.emplace_back(ff());
         }
     } else {
-        warn("stream filter type is not name or array");
+        if (!suppress_warnings) {
+            warn("stream filter type is not name or array");
+        }
         return false;
     }
 
@@ -433,7 +454,9 @@ Stream::filterable(
         // Ignore /DecodeParms entirely if /Filters is empty.  At least one case of a file whose
         // /DecodeParms was [ << >> ] when /Filters was empty has been seen in the wild.
         if (!filters.empty() && QIntC::to_size(decode_array.size()) != filters.size()) {
-            warn("stream /DecodeParms length is inconsistent with filters");
+            if (!suppress_warnings) {
+                warn("stream /DecodeParms length is inconsistent with filters");
+            }
             return false;
         }
 
@@ -492,7 +515,7 @@ Stream::pipeStreamData(
 
     ContentNormalizer normalizer;
     if (filter) {
-        if (encode_flags & qpdf_ef_compress) {
+        if ((encode_flags & qpdf_ef_compress) && !(encode_flags & ef_filter_only)) {
             auto new_pipeline =
                 std::make_unique<Pl_Flate>("compress stream", pipeline, Pl_Flate::a_deflate);
             pipeline = new_pipeline.get();
@@ -601,6 +624,7 @@ Stream::replaceStreamData(
     QPDFObjectHandle const& decode_parms)
 {
     auto s = stream();
+    obj->modified();
     s->stream_data = data;
     s->stream_provider = nullptr;
     replaceFilterData(filter, decode_parms, data->getSize());
@@ -613,6 +637,7 @@ Stream::replaceStreamData(
     QPDFObjectHandle const& decode_parms)
 {
     auto s = stream();
+    obj->modified();
     s->stream_provider = provider;
     s->stream_data = nullptr;
     replaceFilterData(filter, decode_parms, 0);
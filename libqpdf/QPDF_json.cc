@@ -871,6 +871,10 @@ QPDF::writeJSON(
     }
     first_key = false;
 
+    // Resolve all objects before calling getObjectCount so the object cache can be trimmed while
+    // doing so.
+    fixDanglingReferences();
+
     /* clang-format off */
     jw << "\n"
           "  \"qpdf\": [\n"
@@ -910,6 +914,7 @@ QPDF::writeJSON(
                 obj.writeJSON(version, jw, true);
             }
         }
+        trimObjectCache();
     }
     if (all_objects || wanted_objects.contains("trailer")) {
         if (!first) {
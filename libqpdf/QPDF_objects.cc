@@ -2,9 +2,11 @@
 
 #include <qpdf/QPDF_private.hh>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstring>
+#include <deque>
 #include <limits>
 #include <map>
 #include <regex>
@@ -16,6 +18,8 @@
 #include <qpdf/InputSource_private.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
+#include <qpdf/Pl_Buffer.hh>
+#include <qpdf/Pl_Flate.hh>
 #include <qpdf/QPDFExc.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
@@ -23,6 +27,7 @@
 #include <qpdf/QPDFParser.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
+#include <qpdf/ThreadPool.hh>
 #include <qpdf/Util.hh>
 
 using namespace qpdf;
@@ -84,6 +89,104 @@ namespace
                 "another process method) or after closeInputSource");
         }
     };
+
+    // Read a file sequentially in large blocks to quickly find the start of each line and its
+    // first non-white-space character while reconstructing the cross-reference table.
+    class LineScanner
+    {
+      public:
+        LineScanner(InputSource& file, qpdf_offset_t eof) :
+            file(file),
+            eof(eof)
+        {
+        }
+
+        // Return the first character at or after offset that is not white space as defined by the
+        // tokenizer, or eof.
+        qpdf_offset_t
+        skip_space(qpdf_offset_t offset)
+        {
+            while (offset < eof && load(offset)) {
+                auto ch = at(offset);
+                if (!(ch == '\0' || util::is_space(ch))) {
+                    break;
+                }
+                ++offset;
+            }
+            return std::min(offset, eof);
+        }
+
+        // Return the start of the line after the one containing offset, or eof. As with
+        // InputSource::findAndSkipNextEOL, a sequence of CR and LF characters ends a line.
+        qpdf_offset_t
+        next_line(qpdf_offset_t offset)
+        {
+            while (offset < eof && load(offset)) {
+                auto eol = std::min(find('\n', lf, offset), find('\r', cr, offset));
+                offset = eol;
+                if (eol < end()) {
+                    break;
+                }
+            }
+            while (offset < eof && load(offset) && (at(offset) == '\r' || at(offset) == '\n')) {
+                ++offset;
+            }
+            return std::min(offset, eof);
+        }
+
+        char
+        at(qpdf_offset_t offset) const
+        {
+            return block[static_cast<size_t>(offset - start)];
+        }
+
+      private:
+        // Make sure that offset is in the current block. Return false if it is past the end of the
+        // file.
+        bool
+        load(qpdf_offset_t offset)
+        {
+            if (offset >= start && offset < end()) {
+                return true;
+            }
+            block.resize(block_size);
+            file.seek(offset, SEEK_SET);
+            block.resize(file.read(block.data(), block_size));
+            start = offset;
+            cr = -1;
+            lf = -1;
+            return !block.empty();
+        }
+
+        qpdf_offset_t
+        end() const
+        {
+            return start + static_cast<qpdf_offset_t>(block.size());
+        }
+
+        // Return the first occurrence of ch at or after offset in the current block, or the end of
+        // the block. The result is remembered in cache so that repeated searches don't scan the
+        // same part of the block again.
+        qpdf_offset_t
+        find(char ch, qpdf_offset_t& cache, qpdf_offset_t offset)
+        {
+            if (cache < offset) {
+                auto p = block.data() + (offset - start);
+                auto found = static_cast<char const*>(memchr(p, ch, QIntC::to_size(end() - offset)));
+                cache = found ? offset + (found - p) : end();
+            }
+            return cache;
+        }
+
+        static constexpr size_t block_size = 1 << 20;
+
+        InputSource& file;
+        qpdf_offset_t eof;
+        std::string block;
+        qpdf_offset_t start{0};
+        qpdf_offset_t cr{-1};
+        qpdf_offset_t lf{-1};
+    };
 } // namespace
 
 bool
@@ -137,6 +240,7 @@ QPDF::parse(char const* password)
         }
         try {
             read_xref(xref_offset);
+            m->last_xref_offset = xref_offset;
         } catch (QPDFExc&) {
             throw;
         } catch (std::exception& e) {
@@ -228,7 +332,21 @@ QPDF::reconstruct_xref(QPDFExc& e, bool found_startxref)
     m->file->seek(0, SEEK_SET);
     // Don't allow very long tokens here during recovery. All the interesting tokens are covered.
     static size_t const MAX_LEN = 10;
-    while (m->file->tell() < eof) {
+    LineScanner scanner(*m->file, eof);
+    qpdf_offset_t line = 0;
+    while (line < eof) {
+        // Only the first token of each line is examined. Most lines can be ruled out by looking at
+        // the first character of that token, which avoids running the tokenizer on them. Lines
+        // starting with a comment or a token that may span lines are handled by the tokenizer.
+        auto first = scanner.skip_space(line);
+        if (first >= eof) {
+            break;
+        }
+        if (!strchr("0123456789+-ts%(<", scanner.at(first))) {
+            line = scanner.next_line(first);
+            continue;
+        }
+        m->file->seek(line, SEEK_SET);
         QPDFTokenizer::Token t1 = readToken(*m->file, MAX_LEN);
         qpdf_offset_t token_start = m->file->tell() - toO(t1.getValue().length());
         if (t1.isInteger()) {
@@ -252,6 +370,7 @@ QPDF::reconstruct_xref(QPDFExc& e, bool found_startxref)
         }
         check_warnings();
         m->file->findAndSkipNextEOL();
+        line = m->file->tell();
     }
 
     if (!found_startxref && !startxrefs.empty() && !found_objects.empty() &&
@@ -285,6 +404,7 @@ QPDF::reconstruct_xref(QPDFExc& e, bool found_startxref)
         check_warnings();
     }
     m->deleted_objects.clear();
+    reserveTables();
 
     for (auto it = trailers.rbegin(); it != trailers.rend(); it++) {
         m->file->seek(*it, SEEK_SET);
@@ -457,7 +577,7 @@ QPDF::read_xref(qpdf_offset_t xref_offset, bool in_stream_recovery)
     int size = m->trailer.getKey("/Size").getIntValueAsInt();
     int max_obj = 0;
     if (!m->xref_table.empty()) {
-        max_obj = m->xref_table.rbegin()->first.getObj();
+        max_obj = m->xref_table.last().getObj();
     }
     if (!m->deleted_objects.empty()) {
         max_obj = std::max(max_obj, *(m->deleted_objects.rbegin()));
@@ -484,6 +604,20 @@ QPDF::read_xref(qpdf_offset_t xref_offset, bool in_stream_recovery)
         }
         last_og = item.first;
     }
+    reserveTables();
+}
+
+void
+QPDF::reserveTables()
+{
+    // Entries read before the full extent of the xref table was known may have been stored outside
+    // the dense part of the tables. Now that we know the highest object id, make room for all
+    // objects.
+    if (!m->xref_table.empty()) {
+        auto size = toS(m->xref_table.last().getObj()) + 1;
+        m->xref_table.reserve(size);
+        m->obj_cache.reserve(size);
+    }
 }
 
 bool
@@ -1095,33 +1229,163 @@ QPDF::showXRefTable()
 }
 
 // Resolve all objects in the xref table. If this triggers a xref table reconstruction abort and
-// return false. Otherwise return true.
+// return false. Otherwise return true. If trim is true, trim the object cache as objects are
+// resolved. The cache is not trimmed between objects from the same object stream, since they are
+// loaded together.
 bool
-QPDF::resolveXRefTable()
+QPDF::resolveXRefTable(bool trim)
 {
     bool may_change = !m->reconstructed_xref;
-    for (auto& iter: m->xref_table) {
-        if (isUnresolved(iter.first)) {
-            resolve(iter.first);
+    if (m->object_stream_decode_threads != 1 && !resolveObjectStreamsInParallel(trim)) {
+        return false;
+    }
+    int last_stream = 0;
+    for (auto& [og, entry]: m->xref_table) {
+        if (trim) {
+            int stream = entry.getType() == 2 ? entry.getObjStreamNumber() : 0;
+            if (stream == 0 || stream != last_stream) {
+                trimObjectCache();
+            }
+            last_stream = stream;
+        }
+        if (isUnresolved(og)) {
+            resolve(og);
+            if (may_change && m->reconstructed_xref) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Resolve the objects in all object streams, decompressing the object streams on worker threads.
+// Reading the raw stream data and parsing objects require access to the QPDF object, so those are
+// done on this thread. Only a limited number of decompressed object streams are kept in memory at
+// any time. Object streams that can't be decoded cleanly by a worker are left alone so that they
+// are resolved, with the usual warnings, by resolveXRefTable. If this triggers a xref table
+// reconstruction abort and return false. Otherwise return true.
+bool
+QPDF::resolveObjectStreamsInParallel(bool trim)
+{
+    if (m->encp->encrypted) {
+        return true;
+    }
+    bool may_change = !m->reconstructed_xref;
+
+    // object stream number -> an unresolved object contained in it
+    std::map<int, QPDFObjGen> streams;
+    for (auto const& [og, entry]: m->xref_table) {
+        if (entry.getType() == 2 && isUnresolved(og)) {
+            auto stream_number = entry.getObjStreamNumber();
+            if (!m->resolved_object_streams.contains(stream_number)) {
+                streams.try_emplace(stream_number, og);
+            }
+        }
+    }
+    if (streams.size() < 2) {
+        return true;
+    }
+    QTC::TC("qpdf", "QPDF decode object streams in parallel");
+
+    ThreadPool pool(m->object_stream_decode_threads);
+    auto const max_pending = 4 * pool.size();
+    std::deque<std::pair<int, std::future<std::shared_ptr<Buffer>>>> pending;
+    auto next = streams.cbegin();
+    while (next != streams.cend() || !pending.empty()) {
+        while (next != streams.cend() && pending.size() < max_pending) {
+            if (auto decoder = objectStreamDecoder(next->first)) {
+                pending.emplace_back(next->first, pool.submit(std::move(decoder)));
+            }
+            ++next;
+        }
+        if (pending.empty()) {
+            continue;
+        }
+        auto [stream_number, decoded] = std::move(pending.front());
+        pending.pop_front();
+        if (auto data = decoded.get()) {
+            m->decoded_object_streams[stream_number] = data;
+            // Resolve through the normal path so that errors are handled in the usual way.
+            resolve(streams[stream_number]);
+            m->decoded_object_streams.erase(stream_number);
             if (may_change && m->reconstructed_xref) {
                 return false;
             }
+            if (trim) {
+                trimObjectCache();
+            }
         }
     }
     return true;
 }
 
+// Read the raw data of an object stream and return a function that decodes it, or an empty
+// function if the object stream is not suitable for decoding on another thread. The returned
+// function doesn't access the QPDF object and returns nullptr if decoding fails or causes any
+// warnings.
+std::function<std::shared_ptr<Buffer>()>
+QPDF::objectStreamDecoder(int obj_stream_number)
+{
+    try {
+        auto obj_stream = getObject(obj_stream_number, 0).as_stream();
+        if (!obj_stream || obj_stream.getLength() == 0 || obj_stream.isDataModified() ||
+            obj_stream.getStreamDataBuffer() || obj_stream.getStreamDataProvider()) {
+            return {};
+        }
+        std::vector<std::shared_ptr<QPDFStreamFilter>> filters;
+        if (!obj_stream.filterable(qpdf_dl_specialized, filters, true)) {
+            return {};
+        }
+        Pl_Buffer raw("raw object stream data");
+        if (!obj_stream.pipeStreamData(&raw, nullptr, 0, qpdf_dl_none, true, false)) {
+            return {};
+        }
+        return [data = raw.getBufferSharedPointer(),
+                filters = std::move(filters)]() -> std::shared_ptr<Buffer> {
+            Pl_Buffer decoded("decoded object stream data");
+            Pipeline* pipeline = &decoded;
+            bool warned = false;
+            for (auto f_iter = filters.rbegin(); f_iter != filters.rend(); ++f_iter) {
+                if (auto decode_pipeline = (*f_iter)->getDecodePipeline(pipeline)) {
+                    pipeline = decode_pipeline;
+                }
+                if (auto* flate = dynamic_cast<Pl_Flate*>(pipeline)) {
+                    flate->setWarnCallback([&warned](char const*, int) { warned = true; });
+                }
+            }
+            try {
+                pipeline->write(data->getBuffer(), data->getSize());
+                pipeline->finish();
+            } catch (std::exception&) {
+                return nullptr;
+            }
+            return warned ? nullptr : decoded.getBufferSharedPointer();
+        };
+    } catch (std::exception&) {
+        return {};
+    }
+}
+
 // Ensure all objects in the pdf file, including those in indirect references, appear in the object
 // cache.
 void
 QPDF::fixDanglingReferences(bool force)
+{
+    resolveAllObjects(true);
+}
+
+// Resolve all objects in the xref table unless this has already been done. The object cache must
+// only be trimmed if the caller doesn't hold references to the values of any objects, since
+// trimming may destroy them.
+void
+QPDF::resolveAllObjects(bool trim)
 {
     if (m->fixed_dangling_refs) {
         return;
     }
-    if (!resolveXRefTable()) {
+    if (!resolveXRefTable(trim)) {
         QTC::TC("qpdf", "QPDF fix dangling triggered xref reconstruction");
-        resolveXRefTable();
+        resolveXRefTable(trim);
     }
     m->fixed_dangling_refs = true;
 }
@@ -1131,11 +1395,12 @@ QPDF::getObjectCount()
 {
     // This method returns the next available indirect object number. makeIndirectObject uses it for
     // this purpose. After fixDanglingReferences is called, all objects in the xref table will also
-    // be in obj_cache.
-    fixDanglingReferences();
+    // be in obj_cache. This may be called while objects are being modified, so the object cache is
+    // not trimmed here.
+    resolveAllObjects(false);
     QPDFObjGen og;
     if (!m->obj_cache.empty()) {
-        og = (*(m->obj_cache.rbegin())).first;
+        og = m->obj_cache.last();
     }
     return toS(og.getObj());
 }
@@ -1152,6 +1417,56 @@ QPDF::getAllObjects()
     return result;
 }
 
+void
+QPDF::trimObjectCache()
+{
+    if (m->evictable_objects.size() <= m->object_cache_limit) {
+        return;
+    }
+    // The document catalog is accessed constantly and is sometimes modified by QPDFWriter, so keep
+    // it in memory.
+    auto root = m->trailer.getKey("/Root").getObjGen();
+    while (m->evictable_objects.size() > m->object_cache_limit) {
+        auto og = m->evictable_objects.back();
+        untrackEvictable(og);
+        if (og != root) {
+            evictObject(og);
+        }
+    }
+}
+
+void
+QPDF::untrackEvictable(QPDFObjGen og)
+{
+    if (auto it = m->evictable_positions.find(og); it != m->evictable_positions.end()) {
+        m->evictable_objects.erase(it->second.position);
+        if (auto owner = m->direct_object_owners.find(it->second.description);
+            owner != m->direct_object_owners.end() && owner->second == og) {
+            m->direct_object_owners.erase(owner);
+        }
+        m->evictable_positions.erase(it);
+    }
+}
+
+// Return an object that was read from the file to its unresolved state so that it is read again
+// when it is next accessed.
+void
+QPDF::evictObject(QPDFObjGen og)
+{
+    QTC::TC("qpdf", "QPDF evict object");
+    auto& object = m->obj_cache[og].object;
+    // Move the value out of the object, which is shared by all handles to the object, and detach any
+    // direct objects it contains that may still be referenced by other handles.
+    auto value = QPDFObject::create<QPDF_Unresolved>();
+    object->swapWith(value);
+    object->setDefaultDescription(this, og);
+    QPDFObjectHandle(value).disconnect();
+    if (auto entry = m->xref_table.find(og);
+        entry != m->xref_table.end() && entry->second.getType() == 2) {
+        m->resolved_object_streams.erase(entry->second.getObjStreamNumber());
+    }
+}
+
 void
 QPDF::setLastObjectDescription(std::string const& description, QPDFObjGen og)
 {
@@ -1582,7 +1897,8 @@ QPDF::resolve(QPDFObjGen og)
     ResolveRecorder rr(this, og);
 
     if (m->xref_table.contains(og)) {
-        QPDFXRefEntry const& entry = m->xref_table[og];
+        // Copy the entry since reading the object may add entries to the xref table.
+        QPDFXRefEntry entry = m->xref_table[og];
         try {
             switch (entry.getType()) {
             case 1:
@@ -1672,7 +1988,13 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
     // id, offset, size
     std::vector<std::tuple<int, qpdf_offset_t, size_t>> offsets;
 
-    auto bp = obj_stream.getStreamData(qpdf_dl_specialized);
+    std::shared_ptr<Buffer> bp;
+    if (auto it = m->decoded_object_streams.find(obj_stream_number);
+        it != m->decoded_object_streams.end()) {
+        bp = it->second;
+    } else {
+        bp = obj_stream.getStreamData(qpdf_dl_specialized);
+    }
 
     BufferInputSource input("", bp.get());
 
@@ -1759,10 +2081,14 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
         auto entry = m->xref_table.find(og);
         if (entry != m->xref_table.end() && entry->second.getType() == 2 &&
             entry->second.getObjStreamNumber() == obj_stream_number) {
-            Buffer obj_buffer{b_start + obj_offset, obj_size};
-            is::OffsetBuffer in("", &obj_buffer, obj_offset);
+            is::OffsetBuffer in(
+                "", {reinterpret_cast<char*>(b_start) + obj_offset, obj_size}, obj_offset);
             auto oh = readObjectInStream(in, obj_stream_number, obj_id);
-            updateCache(og, oh.getObj(), end_before_space, end_after_space);
+            // If the object stream is read again because objects in it were evicted, don't replace
+            // objects that are still in memory.
+            if (!m->object_cache_limit || isUnresolved(og)) {
+                updateCache(og, oh.getObj(), end_before_space, end_after_space);
+            }
         } else {
             QTC::TC("qpdf", "QPDF not caching overridden objstm object");
         }
@@ -1790,8 +2116,31 @@ QPDF::updateCache(
         object->move_to(cache.object, destroy);
         cache.end_before_space = end_before_space;
         cache.end_after_space = end_after_space;
+        cache.modified = !destroy;
     } else {
         m->obj_cache[og] = ObjCache(object, end_before_space, end_after_space);
+        m->obj_cache[og].modified = !destroy;
+    }
+    if (!destroy) {
+        m->unparsed_objects.erase(og);
+    }
+    if (m->object_cache_limit) {
+        // Only unmodified objects read from the file may be evicted.
+        if (destroy && end_after_space > 0) {
+            untrackEvictable(og);
+            m->evictable_objects.push_front(og);
+            auto& entry = m->evictable_positions[og];
+            entry.position = m->evictable_objects.begin();
+            // A stream's dictionary is what was parsed from the file.
+            QPDFObjectHandle oh(m->obj_cache[og].object);
+            entry.description =
+                (oh.isStream() ? oh.getDict() : oh).getObjectPtr()->getSharedDescription();
+            if (entry.description) {
+                m->direct_object_owners[entry.description] = og;
+            }
+        } else {
+            untrackEvictable(og);
+        }
     }
 }
 
@@ -1843,7 +2192,8 @@ QPDF::getObjectForParser(int id, int gen, bool parse_pdf)
         return iter->second.object;
     }
     if (m->xref_table.contains(og) || !m->parsed) {
-        return m->obj_cache.insert({og, QPDFObject::create<QPDF_Unresolved>(this, og)})
+        return m->obj_cache
+            .insert({og, QPDFObject::create_in<QPDF_Unresolved>(m->object_arena.get(), this, og)})
             .first->second.object;
     }
     if (parse_pdf) {
@@ -1861,7 +2211,7 @@ QPDF::getObjectForJSON(int id, int gen)
     if (inserted) {
         obj = (m->parsed && !m->xref_table.contains(og))
             ? QPDFObject::create<QPDF_Null>(this, og)
-            : QPDFObject::create<QPDF_Unresolved>(this, og);
+            : QPDFObject::create_in<QPDF_Unresolved>(m->object_arena.get(), this, og);
     }
     return obj;
 }
@@ -1874,8 +2224,8 @@ QPDF::getObject(QPDFObjGen og)
     } else if (m->parsed && !m->xref_table.contains(og)) {
         return QPDFObject::create<QPDF_Null>();
     } else {
-        auto result =
-            m->obj_cache.try_emplace(og, QPDFObject::create<QPDF_Unresolved>(this, og), -1, -1);
+        auto result = m->obj_cache.try_emplace(
+            og, QPDFObject::create_in<QPDF_Unresolved>(m->object_arena.get(), this, og), -1, -1);
         return {result.first->second.object};
     }
 }
@@ -1899,7 +2249,9 @@ QPDF::replaceObject(QPDFObjGen og, QPDFObjectHandle oh)
 void
 QPDF::removeObject(QPDFObjGen og)
 {
+    untrackEvictable(og);
     m->xref_table.erase(og);
+    m->unparsed_objects.erase(og);
     if (auto cached = m->obj_cache.find(og); cached != m->obj_cache.end()) {
         // Take care of any object handles that may be floating around.
         cached->second.object->assign_null();
@@ -1931,6 +2283,12 @@ QPDF::swapObjects(QPDFObjGen og1, QPDFObjGen og2)
     // Force objects to be read from the input source if needed, then swap them in the cache.
     resolve(og1);
     resolve(og2);
+    untrackEvictable(og1);
+    untrackEvictable(og2);
+    m->obj_cache[og1].modified = true;
+    m->obj_cache[og2].modified = true;
+    m->unparsed_objects.erase(og1);
+    m->unparsed_objects.erase(og2);
     m->obj_cache[og1].object->swapWith(m->obj_cache[og2].object);
 }
 
@@ -1939,8 +2297,8 @@ QPDF::tableSize()
 {
     // If obj_cache is dense, accommodate all object in tables,else accommodate only original
     // objects.
-    auto max_xref = !m->xref_table.empty() ? m->xref_table.crbegin()->first.getObj() : 0;
-    auto max_obj = !m->obj_cache.empty() ? m->obj_cache.crbegin()->first.getObj() : 0;
+    auto max_xref = !m->xref_table.empty() ? m->xref_table.last().getObj() : 0;
+    auto max_obj = !m->obj_cache.empty() ? m->obj_cache.last().getObj() : 0;
     auto max_id = std::numeric_limits<int>::max() - 1;
     if (max_obj >= max_id || max_xref >= max_id) {
         // Temporary fix. Long-term solution is
@@ -1966,6 +2324,71 @@ QPDF::getCompressibleObjSet()
     return getCompressibleObjGens<bool>();
 }
 
+qpdf_offset_t
+QPDF::copyInputFile(Pipeline* pipeline)
+{
+    auto fail = [this](std::string const& reason) {
+        return std::runtime_error(
+            "unable to write an incremental update of " + m->file->getName() + ": " + reason);
+    };
+    if (m->encp->encrypted) {
+        throw fail("the file is encrypted");
+    }
+    if (m->reconstructed_xref || m->last_xref_offset == 0) {
+        throw fail("the file has no valid cross-reference table");
+    }
+    m->file->seek(0, SEEK_END);
+    auto size = m->file->tell();
+    copyStreamData(0, toS(size), pipeline);
+    return m->last_xref_offset;
+}
+
+std::vector<QPDFObjGen>
+QPDF::getChangedObjects()
+{
+    // Changes to direct objects can't be attributed to the indirect objects that contain them, so if
+    // there were any, each unflagged object that has been read is compared with a fresh copy of it
+    // read from the input file.
+    std::unique_ptr<QPDF> original;
+    if (m->direct_objects_modified) {
+        QTC::TC("qpdf", "QPDF compare objects with input file");
+        original = std::make_unique<QPDF>();
+        original->setSuppressWarnings(true);
+        original->processInputSource(m->file);
+    }
+    std::vector<QPDFObjGen> result;
+    for (auto const& [og, cache]: m->obj_cache) {
+        if (cache.object->isUnresolved() ||
+            (!result.empty() && result.back().getObj() == og.getObj())) {
+            continue;
+        }
+        if (!m->xref_table.contains(og)) {
+            // References to objects that don't exist resolve to null and are not new objects.
+            if (cache.object->getTypeCode() != ::ot_null) {
+                result.emplace_back(og);
+            }
+        } else if (cache.modified || (original && changedSinceRead(og, *original))) {
+            result.emplace_back(og);
+        }
+    }
+    return result;
+}
+
+bool
+QPDF::changedSinceRead(QPDFObjGen og, QPDF& original)
+{
+    QPDFObjectHandle current(m->obj_cache[og].object);
+    auto read = original.getObject(og);
+    if (current.isStream() != read.isStream()) {
+        return true;
+    }
+    // Changes to stream data are always flagged, so only the dictionaries have to be compared.
+    if (current.isStream()) {
+        return current.getDict().unparseResolved() != read.getDict().unparseResolved();
+    }
+    return current.unparseResolved() != read.unparseResolved();
+}
+
 template <typename T>
 std::vector<T>
 QPDF::getCompressibleObjGens()
@@ -1980,6 +2403,10 @@ QPDF::getCompressibleObjGens()
     QPDFObjectHandle encryption_dict = m->trailer.getKey("/Encrypt");
     QPDFObjGen encryption_dict_og = encryption_dict.getObjGen();
 
+    // Resolve all objects before calling getObjectCount so the object cache can be trimmed while
+    // doing so. The queue only holds object handles, so it is also safe to trim the cache during
+    // the traversal.
+    fixDanglingReferences();
     const size_t max_obj = getObjectCount();
     std::vector<bool> visited(max_obj, false);
     std::vector<QPDFObjectHandle> queue;
@@ -1994,6 +2421,7 @@ QPDF::getCompressibleObjGens()
         throw std::logic_error("Unsupported type in QPDF::getCompressibleObjGens");
     }
     while (!queue.empty()) {
+        trimObjectCache();
         auto obj = queue.back();
         queue.pop_back();
         if (obj.getObjectID() > 0) {
@@ -2011,8 +2439,7 @@ QPDF::getCompressibleObjGens()
             // Check whether this is the current object. If not, remove it (which changes it into a
             // direct null and therefore stops us from revisiting it) and move on to the next object
             // in the queue.
-            auto upper = m->obj_cache.upper_bound(og);
-            if (upper != m->obj_cache.end() && upper->first.getObj() == og.getObj()) {
+            if (m->obj_cache.has_later_generation(og)) {
                 removeObject(og);
                 continue;
             }
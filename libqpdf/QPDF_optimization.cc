@@ -349,6 +349,32 @@ QPDF::updateObjectMaps(
     }
 }
 
+std::vector<std::set<QPDFObjGen>>
+QPDF::getPageObjects()
+{
+    // Traverse the pages the same way optimize does, but leave the object <-> user maps as they
+    // were so that a later call to optimize is not affected.
+    std::map<ObjUser, std::set<QPDFObjGen>> saved_obj_user_to_objects;
+    std::map<QPDFObjGen, std::set<ObjUser>> saved_object_to_obj_users;
+    std::swap(saved_obj_user_to_objects, m->obj_user_to_objects);
+    std::swap(saved_object_to_obj_users, m->object_to_obj_users);
+
+    pushInheritedAttributesToPage(true, false);
+    std::vector<std::set<QPDFObjGen>> result(m->all_pages.size());
+    for (size_t pageno = 0; pageno < m->all_pages.size(); ++pageno) {
+        updateObjectMaps(ObjUser(ObjUser::ou_page, toI(pageno)), m->all_pages.at(pageno), nullptr);
+    }
+    for (auto& [ou, objects]: m->obj_user_to_objects) {
+        // Thumbnails are used by the same page.
+        auto& page_objects = result.at(toS(ou.pageno));
+        page_objects.merge(objects);
+    }
+
+    std::swap(saved_obj_user_to_objects, m->obj_user_to_objects);
+    std::swap(saved_object_to_obj_users, m->object_to_obj_users);
+    return result;
+}
+
 void
 QPDF::filterCompressedObjects(std::map<int, int> const& object_stream_data)
 {
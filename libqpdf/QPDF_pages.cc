@@ -128,6 +128,9 @@ QPDF::getAllPagesInternal(
             0,
             "Loop detected in /Pages structure (getAllPages)");
     }
+    // Kids may be replaced in place below, so keep the node and its /Kids array in memory.
+    untrackEvictable(cur_node.getObjGen());
+    untrackEvictable(kids.getObjGen());
     int i = -1;
     for (auto& kid: kids.as_array()) {
         ++i;
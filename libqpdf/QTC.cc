@@ -3,6 +3,7 @@
 #include <qpdf/QUtil.hh>
 #include <cstdio>
 #include <map>
+#include <mutex>
 #include <set>
 
 static bool
@@ -15,6 +16,10 @@ tc_active(char const* const scope)
 void
 QTC::TC_real(char const* const scope, char const* const ccase, int n)
 {
+    // Coverage cases may be recorded by worker threads.
+    static std::mutex mutex;
+    std::lock_guard lock(mutex);
+
     static std::map<std::string, bool> active;
     auto is_active = active.find(scope);
     if (is_active == active.end()) {
@@ -0,0 +1,424 @@
+#ifndef COMPACTMAP_HH
+#define COMPACTMAP_HH
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A map intended for the small dictionaries that make up most of a PDF file. It supports the subset
+// of the std::map interface used by QPDF.
+//
+// Up to 'Threshold' elements are held in a std::vector sorted by key. This avoids allocating a tree
+// node per element and makes look-ups a binary search over contiguous memory. If the map grows
+// beyond 'Threshold' elements, all elements are moved into a std::map, which is then used for the
+// life of the CompactMap, so that very large dictionaries don't suffer from quadratic insertion
+// cost. The std::map is held by pointer to keep the CompactMap itself small, since it is embedded
+// in every QPDFObject.
+//
+// Look-ups accept any type that can be compared with Key, so that, e.g., a map with InternedName
+// keys can be searched with a std::string without constructing an InternedName.
+//
+// Iteration is in ascending key order, exactly as with std::map. Unlike std::map, the value_type is
+// std::pair<Key, T> rather than std::pair<Key const, T>. Keys must not be modified through
+// iterators. As with std::vector, inserting or erasing elements invalidates iterators and
+// references to elements.
+template <class Key, class T, size_t Threshold = 64>
+class CompactMap
+{
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+
+  private:
+    using vector_t = std::vector<value_type>;
+    using map_t = std::map<Key, value_type, std::less<>>;
+
+    template <bool Const>
+    class Iterator
+    {
+        friend class CompactMap;
+        friend class Iterator<!Const>;
+        using vec_it = std::
+            conditional_t<Const, typename vector_t::const_iterator, typename vector_t::iterator>;
+        using map_it =
+            std::conditional_t<Const, typename map_t::const_iterator, typename map_t::iterator>;
+
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = CompactMap::value_type;
+        using reference = std::conditional_t<Const, value_type const&, value_type&>;
+        using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+
+        Iterator() = default;
+
+        // Allow conversion from iterator to const_iterator.
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(Iterator<false> const& other) :
+            v_it(other.v_it),
+            m_it(other.m_it),
+            in_map(other.in_map)
+        {
+        }
+
+        reference
+        operator*() const
+        {
+            return in_map ? m_it->second : *v_it;
+        }
+
+        pointer
+        operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator&
+        operator++()
+        {
+            if (in_map) {
+                ++m_it;
+            } else {
+                ++v_it;
+            }
+            return *this;
+        }
+
+        Iterator
+        operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        Iterator&
+        operator--()
+        {
+            if (in_map) {
+                --m_it;
+            } else {
+                --v_it;
+            }
+            return *this;
+        }
+
+        Iterator
+        operator--(int)
+        {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool
+        operator==(Iterator const& rhs) const
+        {
+            return in_map ? m_it == rhs.m_it : v_it == rhs.v_it;
+        }
+
+      private:
+        explicit Iterator(vec_it it) :
+            v_it(it)
+        {
+        }
+
+        explicit Iterator(map_it it) :
+            m_it(it),
+            in_map(true)
+        {
+        }
+
+        vec_it v_it{};
+        map_it m_it{};
+        bool in_map{false};
+    };
+
+  public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    CompactMap() = default;
+    CompactMap(CompactMap&&) = default;
+    CompactMap& operator=(CompactMap&&) = default;
+    ~CompactMap() = default;
+
+    CompactMap(CompactMap const& other) :
+        small(other.small),
+        large(other.large ? std::make_unique<map_t>(*other.large) : nullptr)
+    {
+    }
+
+    CompactMap&
+    operator=(CompactMap const& other)
+    {
+        if (this != &other) {
+            small = other.small;
+            large = other.large ? std::make_unique<map_t>(*other.large) : nullptr;
+        }
+        return *this;
+    }
+
+    // Construct from a std::map or another container that is sorted in the same order as Key.
+    template <class M>
+    explicit CompactMap(M const& items)
+    {
+        if (items.size() > Threshold) {
+            large = std::make_unique<map_t>();
+            for (auto const& [key, value]: items) {
+                Key k(key);
+                large->emplace_hint(large->end(), k, value_type(k, value));
+            }
+        } else {
+            small.reserve(items.size());
+            for (auto const& [key, value]: items) {
+                small.emplace_back(Key(key), value);
+            }
+        }
+    }
+
+    template <class M = std::map<Key, T>>
+    M
+    as_map() const
+    {
+        M result;
+        for (auto const& [key, value]: *this) {
+            result.emplace_hint(result.end(), key, value);
+        }
+        return result;
+    }
+
+    bool
+    empty() const
+    {
+        return large ? large->empty() : small.empty();
+    }
+
+    size_t
+    size() const
+    {
+        return large ? large->size() : small.size();
+    }
+
+    iterator
+    begin()
+    {
+        return large ? iterator(large->begin()) : iterator(small.begin());
+    }
+
+    iterator
+    end()
+    {
+        return large ? iterator(large->end()) : iterator(small.end());
+    }
+
+    const_iterator
+    begin() const
+    {
+        return large ? const_iterator(large->begin()) : const_iterator(small.begin());
+    }
+
+    const_iterator
+    end() const
+    {
+        return large ? const_iterator(large->end()) : const_iterator(small.end());
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    reverse_iterator
+    rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator
+    rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator
+    crbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator
+    crend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class K>
+    iterator
+    find(K const& key)
+    {
+        if (large) {
+            return iterator(large->find(key));
+        }
+        auto it = lower_bound(key);
+        return it != small.end() && it->first == key ? iterator(it) : end();
+    }
+
+    template <class K>
+    const_iterator
+    find(K const& key) const
+    {
+        if (large) {
+            return const_iterator(large->find(key));
+        }
+        auto it = lower_bound(key);
+        return it != small.end() && it->first == key ? const_iterator(it) : end();
+    }
+
+    template <class K>
+    bool
+    contains(K const& key) const
+    {
+        return find(key) != end();
+    }
+
+    // As with std::map, accessing a non-existent element inserts a default constructed element.
+    template <class K>
+    T&
+    operator[](K&& key)
+    {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    // Look-ups accept any type that can be compared with Key. A Key is only constructed from key if
+    // a new element is inserted.
+    template <class K, class... Args>
+    std::pair<iterator, bool>
+    try_emplace(K&& key, Args&&... args)
+    {
+        if (!large) {
+            auto it = lower_bound(key);
+            if (it != small.end() && it->first == key) {
+                return {iterator(it), false};
+            }
+            if (small.size() < Threshold) {
+                it = small.emplace(
+                    it,
+                    std::piecewise_construct,
+                    std::forward_as_tuple(std::forward<K>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+                return {iterator(it), true};
+            }
+            move_to_map();
+        }
+        auto it = large->lower_bound(key);
+        if (it != large->end() && it->first == key) {
+            return {iterator(it), false};
+        }
+        Key k(std::forward<K>(key));
+        it = large->emplace_hint(
+            it,
+            std::piecewise_construct,
+            std::forward_as_tuple(k),
+            std::forward_as_tuple(
+                std::piecewise_construct,
+                std::forward_as_tuple(k),
+                std::forward_as_tuple(std::forward<Args>(args)...)));
+        return {iterator(it), true};
+    }
+
+    template <class K, class M>
+    std::pair<iterator, bool>
+    insert_or_assign(K&& key, M&& obj)
+    {
+        auto result = try_emplace(std::forward<K>(key));
+        result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    template <class K>
+    size_t
+    erase(K const& key)
+    {
+        if (large) {
+            auto it = large->find(key);
+            if (it == large->end()) {
+                return 0;
+            }
+            large->erase(it);
+            return 1;
+        }
+        auto it = lower_bound(key);
+        if (it != small.end() && it->first == key) {
+            small.erase(it);
+            return 1;
+        }
+        return 0;
+    }
+
+    void
+    clear()
+    {
+        small.clear();
+        large.reset();
+    }
+
+    // Release excess capacity of the vector, e.g. once a dictionary has been fully parsed.
+    void
+    shrink_to_fit()
+    {
+        small.shrink_to_fit();
+    }
+
+  private:
+    template <class K>
+    typename vector_t::iterator
+    lower_bound(K const& key)
+    {
+        return std::lower_bound(small.begin(), small.end(), key, [](value_type const& v, auto& k) {
+            return std::less<>()(v.first, k);
+        });
+    }
+
+    template <class K>
+    typename vector_t::const_iterator
+    lower_bound(K const& key) const
+    {
+        return std::lower_bound(small.begin(), small.end(), key, [](value_type const& v, auto& k) {
+            return std::less<>()(v.first, k);
+        });
+    }
+
+    void
+    move_to_map()
+    {
+        large = std::make_unique<map_t>();
+        for (auto& item: small) {
+            auto key = item.first;
+            large->emplace_hint(large->end(), std::move(key), std::move(item));
+        }
+        small.clear();
+        small.shrink_to_fit();
+    }
+
+    vector_t small;
+    std::unique_ptr<map_t> large;
+};
+
+#endif // COMPACTMAP_HH
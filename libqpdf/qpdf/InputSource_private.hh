@@ -3,18 +3,31 @@
 
 #include <qpdf/BufferInputSource.hh>
 #include <qpdf/InputSource.hh>
+#include <qpdf/QIntC.hh>
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 
 namespace qpdf::is
 {
+    // An input source that reads directly from memory. The memory is not owned by the
+    // OffsetBuffer. Offsets are reported relative to global_offset, which is useful for reading
+    // objects from object streams.
+    //
+    // In addition to the InputSource interface, the OffsetBuffer gives direct access to the
+    // unread data, which allows the tokenizer to avoid copying the data into the InputSource
+    // buffer and making virtual calls for each token.
     class OffsetBuffer final: public InputSource
     {
       public:
-        OffsetBuffer(std::string const& description, Buffer* buf, qpdf_offset_t global_offset) :
-            proxied(description, buf),
+        OffsetBuffer(
+            std::string const& description, std::string_view data, qpdf_offset_t global_offset) :
+            description(description),
+            data(data),
             global_offset(global_offset)
         {
             if (global_offset < 0) {
@@ -23,33 +36,67 @@ namespace qpdf::is
             last_offset = global_offset;
         }
 
+        OffsetBuffer(std::string const& description, Buffer* buf, qpdf_offset_t global_offset) :
+            OffsetBuffer(
+                description,
+                buf ? std::string_view(reinterpret_cast<char*>(buf->getBuffer()), buf->getSize())
+                    : std::string_view(),
+                global_offset)
+        {
+        }
+
         ~OffsetBuffer() final = default;
 
         qpdf_offset_t
         findAndSkipNextEOL() final
         {
-            return proxied.findAndSkipNextEOL() + global_offset;
+            auto rest = remaining();
+            auto eol = rest.find_first_of("\r\n");
+            if (eol == std::string_view::npos) {
+                pos = size();
+                return size() + global_offset;
+            }
+            auto result = pos + qpdf_offset_t(eol);
+            auto next = rest.find_first_not_of("\r\n", eol);
+            pos = next == std::string_view::npos ? size() : pos + qpdf_offset_t(next);
+            return result + global_offset;
         }
 
         std::string const&
         getName() const final
         {
-            return proxied.getName();
+            return description;
         }
 
         qpdf_offset_t
         tell() final
         {
-            return proxied.tell() + global_offset;
+            return pos + global_offset;
         }
 
         void
         seek(qpdf_offset_t offset, int whence) final
         {
-            if (whence == SEEK_SET) {
-                proxied.seek(offset - global_offset, whence);
-            } else {
-                proxied.seek(offset, whence);
+            switch (whence) {
+            case SEEK_SET:
+                pos = offset - global_offset;
+                break;
+
+            case SEEK_END:
+                QIntC::range_check(size(), offset);
+                pos = size() + offset;
+                break;
+
+            case SEEK_CUR:
+                QIntC::range_check(pos, offset);
+                pos += offset;
+                break;
+
+            default:
+                throw std::logic_error("INTERNAL ERROR: invalid argument to is::OffsetBuffer::seek");
+            }
+            if (pos < 0) {
+                throw std::runtime_error(description + ": seek before beginning of buffer");
             }
         }
 
@@ -62,20 +109,50 @@ namespace qpdf::is
         size_t
         read(char* buffer, size_t length) final
         {
-            size_t result = proxied.read(buffer, length);
-            setLastOffset(proxied.getLastOffset() + global_offset);
-            return result;
+            auto rest = remaining();
+            last_offset = std::min(pos, size()) + global_offset;
+            auto len = std::min(rest.size(), length);
+            if (len) {
+                memcpy(buffer, rest.data(), len);
+            }
+            pos += qpdf_offset_t(len);
+            return len;
         }
 
         void
         unreadCh(char ch) final
         {
-            proxied.unreadCh(ch);
+            if (pos > 0) {
+                --pos;
+            }
+        }
+
+        // Return the data from the current position to the end of the buffer.
+        std::string_view
+        remaining() const
+        {
+            return pos < size() ? data.substr(size_t(pos)) : std::string_view();
+        }
+
+        // Move the current position forward by count characters, which must not be more than the
+        // size of remaining().
+        void
+        advance(size_t count)
+        {
+            pos += qpdf_offset_t(count);
         }
 
       private:
-        BufferInputSource proxied;
+        qpdf_offset_t
+        size() const
+        {
+            return qpdf_offset_t(data.size());
+        }
+
+        std::string description;
+        std::string_view data;
         qpdf_offset_t global_offset;
+        qpdf_offset_t pos{0};
     };
 
 } // namespace qpdf::is
@@ -145,6 +222,22 @@ InputSource::fastRead(char& ch)
     }
 }
 
+inline std::string_view
+InputSource::fastBuffered() const
+{
+    // Return the characters that fastRead would return without reloading the buffer. The view is
+    // invalidated by any other operation on the input source.
+    return {buffer + buf_idx, size_t(buf_len - buf_idx)};
+}
+
+inline void
+InputSource::fastSkip(size_t count)
+{
+    // Skip count characters that have been examined using fastBuffered.
+    buf_idx += qpdf_offset_t(count);
+    last_offset += qpdf_offset_t(count);
+}
+
 inline void
 InputSource::fastUnread(bool back)
 {
@@ -0,0 +1,142 @@
+#ifndef INTERNEDNAME_HH
+#define INTERNEDNAME_HH
+
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// An InternedName is a reference to an entry in a process-wide table of strings. All
+// InternedNames with the same value share a single copy of the string, so an InternedName is the
+// size of a pointer and two InternedNames can be compared for equality by comparing pointers. It
+// is used for the values of name objects and for dictionary keys, where the same few strings
+// (/Type, /Length, /Resources, ...) are repeated many times.
+//
+// Entries are reference counted and are removed from the table when the last InternedName
+// referring to them is destroyed, so the table doesn't grow without bounds in long-running
+// processes. The table is thread-safe. Creating an InternedName from a string requires a look-up
+// in the table, which is protected by a mutex; copying and destroying InternedNames is lock-free
+// except when the last reference to an entry is released.
+//
+// Ordering of InternedNames is by value and is identical to the ordering of std::string.
+class InternedName
+{
+  public:
+    InternedName() = default;
+
+    explicit InternedName(std::string_view value) :
+        entry(intern(value))
+    {
+    }
+
+    InternedName(InternedName const& other) :
+        entry(other.entry)
+    {
+        if (entry) {
+            entry->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    InternedName(InternedName&& other) noexcept :
+        entry(std::exchange(other.entry, nullptr))
+    {
+    }
+
+    InternedName&
+    operator=(InternedName const& other)
+    {
+        if (entry != other.entry) {
+            InternedName(other).swap(*this);
+        }
+        return *this;
+    }
+
+    InternedName&
+    operator=(InternedName&& other) noexcept
+    {
+        InternedName(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~InternedName()
+    {
+        if (entry) {
+            release(entry);
+        }
+    }
+
+    void
+    swap(InternedName& other) noexcept
+    {
+        std::swap(entry, other.entry);
+    }
+
+    std::string const&
+    str() const
+    {
+        return entry ? entry->value : empty;
+    }
+
+    operator std::string const&() const
+    {
+        return str();
+    }
+
+    std::string_view
+    view() const
+    {
+        return str();
+    }
+
+    friend bool
+    operator==(InternedName const& lhs, InternedName const& rhs)
+    {
+        return lhs.entry == rhs.entry;
+    }
+
+    friend bool
+    operator==(InternedName const& lhs, std::string_view rhs)
+    {
+        return lhs.view() == rhs;
+    }
+
+    friend std::strong_ordering
+    operator<=>(InternedName const& lhs, InternedName const& rhs)
+    {
+        return lhs.entry == rhs.entry ? std::strong_ordering::equal : lhs.view() <=> rhs.view();
+    }
+
+    friend std::strong_ordering
+    operator<=>(InternedName const& lhs, std::string_view rhs)
+    {
+        return lhs.view() <=> rhs;
+    }
+
+    // Return the number of distinct values currently in the table. This is intended for testing.
+    static size_t table_size();
+
+  private:
+    struct Entry
+    {
+        Entry(std::string_view value, size_t hash) :
+            value(value),
+            hash(hash)
+        {
+        }
+
+        std::string const value;
+        size_t const hash;
+        std::atomic<size_t> refs{1};
+    };
+
+    static Entry* intern(std::string_view value);
+    static void release(Entry* entry);
+
+    static std::string const empty;
+
+    Entry* entry{nullptr};
+};
+
+#endif // INTERNEDNAME_HH
@@ -0,0 +1,417 @@
+#ifndef OBJGENTABLE_HH
+#define OBJGENTABLE_HH
+
+#include <qpdf/QPDFObjGen.hh>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A table of objects indexed by QPDFObjGen. This is intended as a more efficient replacement for
+// std::map<QPDFObjGen, T> containers and supports the subset of the std::map interface used by
+// QPDF.
+//
+// Like ObjTable, the table is implemented as a std::vector with the object id implicitly
+// represented by the index of the object, so look-ups for the common case are a single indexed
+// access rather than a tree walk. Unlike ObjTable, keys include the generation. Each slot of the
+// vector holds at most one generation of an object. Other generations of the same object, as well
+// as object ids that are much larger than the number of objects in the table (usually the result
+// of invalid dangling references), are held in the map 'sparse_elements'. On insertion, the vector
+// only grows while it stays reasonably dense. Elements are moved from the sparse map into the
+// vector only by an explicit call to reserve.
+//
+// Iteration is in ascending QPDFObjGen order, exactly as with std::map. An iterator refers either
+// to a dense slot by index or to a sparse element by map iterator, and incrementing it looks up the
+// next element by key, so inserting or erasing elements other than the one an iterator points to
+// does not invalidate the iterator. However, as with std::vector, inserting elements may invalidate
+// references to elements, so references must not be held across insertions.
+
+template <class T>
+class ObjGenTable
+{
+  public:
+    using value_type = std::pair<QPDFObjGen, T>;
+
+  private:
+    using sparse_map = std::map<QPDFObjGen, value_type>;
+
+    template <bool Const>
+    class Iterator
+    {
+        friend class ObjGenTable;
+        friend class Iterator<!Const>;
+        using table_t = std::conditional_t<Const, ObjGenTable const, ObjGenTable>;
+        using map_it = std::
+            conditional_t<Const, typename sparse_map::const_iterator, typename sparse_map::iterator>;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = ObjGenTable::value_type;
+        using reference = std::conditional_t<Const, value_type const&, value_type&>;
+        using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+
+        Iterator() = default;
+
+        // Allow conversion from iterator to const_iterator.
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(Iterator<false> const& other) :
+            table(other.table),
+            idx(other.idx),
+            it(other.it)
+        {
+        }
+
+        reference
+        operator*() const
+        {
+            return idx != npos ? table->dense[idx] : it->second;
+        }
+
+        pointer
+        operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator&
+        operator++()
+        {
+            // Look up both successors by key rather than caching the next sparse position, which
+            // may have been erased while this iterator was on a dense slot.
+            auto og = (**this).first;
+            auto next = idx != npos ? table->sparse_elements.upper_bound(og) : std::next(it);
+            *this = Iterator(table, table->next_dense(og), next);
+            return *this;
+        }
+
+        Iterator
+        operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool
+        operator==(Iterator const& rhs) const
+        {
+            return idx == rhs.idx && (idx != npos || it == rhs.it);
+        }
+
+      private:
+        // idx is the next present dense slot or npos, and it is the next sparse element. The
+        // iterator points to whichever comes first. If that is the sparse element, idx is set to
+        // npos, and it is only used while idx is npos.
+        Iterator(table_t* table, size_t idx, map_it it) :
+            table(table),
+            idx(idx),
+            it(it)
+        {
+            if (idx >= table->dense.size() ||
+                (it != table->sparse_elements.end() && it->first < table->dense[idx].first)) {
+                this->idx = npos;
+            }
+        }
+
+        table_t* table{nullptr};
+        size_t idx{npos};
+        map_it it;
+    };
+
+  public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    ObjGenTable() = default;
+
+    bool
+    empty() const
+    {
+        return count == 0;
+    }
+
+    size_t
+    size() const
+    {
+        return count;
+    }
+
+    void
+    clear()
+    {
+        dense.clear();
+        sparse_elements.clear();
+        count = 0;
+        dense_last = 0;
+    }
+
+    iterator
+    begin()
+    {
+        return {this, next_dense(0), sparse_elements.begin()};
+    }
+
+    iterator
+    end()
+    {
+        return {this, npos, sparse_elements.end()};
+    }
+
+    const_iterator
+    begin() const
+    {
+        return {this, next_dense(0), sparse_elements.begin()};
+    }
+
+    const_iterator
+    end() const
+    {
+        return {this, npos, sparse_elements.end()};
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    bool
+    contains(QPDFObjGen og) const
+    {
+        return dense_match(og) || sparse_elements.contains(og);
+    }
+
+    iterator
+    find(QPDFObjGen og)
+    {
+        if (dense_match(og)) {
+            return {this, to_idx(og), sparse_elements.lower_bound(og)};
+        }
+        auto it = sparse_elements.find(og);
+        return it == sparse_elements.end() ? end() : iterator{this, next_dense(og), it};
+    }
+
+    const_iterator
+    find(QPDFObjGen og) const
+    {
+        if (dense_match(og)) {
+            return {this, to_idx(og), sparse_elements.lower_bound(og)};
+        }
+        auto it = sparse_elements.find(og);
+        return it == sparse_elements.end() ? end() : const_iterator{this, next_dense(og), it};
+    }
+
+    // As with std::map, access a non-existent element inserts a default constructed element.
+    T&
+    operator[](QPDFObjGen og)
+    {
+        return try_emplace(og).first->second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool>
+    try_emplace(QPDFObjGen og, Args&&... args)
+    {
+        if (auto it = find(og); it != end()) {
+            return {it, false};
+        }
+        ++count;
+        auto idx = to_idx(og);
+        if (og.getObj() >= 0 && idx >= dense.size() && idx < max_dense_size()) {
+            grow(idx);
+        }
+        if (idx < dense.size() && !present(idx)) {
+            dense[idx] = value_type(og, T(std::forward<Args>(args)...));
+            dense_last = std::max(dense_last, idx);
+            return {{this, idx, sparse_elements.lower_bound(og)}, true};
+        }
+        auto it = sparse_elements
+                      .try_emplace(og, std::piecewise_construct, std::forward_as_tuple(og),
+                                   std::forward_as_tuple(std::forward<Args>(args)...))
+                      .first;
+        return {{this, next_dense(og), it}, true};
+    }
+
+    std::pair<iterator, bool>
+    insert(value_type&& value)
+    {
+        return try_emplace(value.first, std::move(value.second));
+    }
+
+    size_t
+    erase(QPDFObjGen og)
+    {
+        if (dense_match(og)) {
+            erase_dense(to_idx(og));
+            return 1;
+        }
+        if (sparse_elements.erase(og)) {
+            --count;
+            return 1;
+        }
+        return 0;
+    }
+
+    void
+    erase(iterator iter)
+    {
+        if (iter.idx != npos) {
+            erase_dense(iter.idx);
+        } else {
+            sparse_elements.erase(iter.it);
+            --count;
+        }
+    }
+
+    // Return the largest key in the table. The table must not be empty. This replaces
+    // std::map::rbegin()->first.
+    QPDFObjGen
+    last() const
+    {
+        QPDFObjGen result;
+        if (dense_last < dense.size() && present(dense_last)) {
+            result = dense[dense_last].first;
+        }
+        if (!sparse_elements.empty() && result < sparse_elements.rbegin()->first) {
+            result = sparse_elements.rbegin()->first;
+        }
+        return result;
+    }
+
+    // Return true if the table contains a later generation of the object identified by og. This
+    // replaces checking the result of std::map::upper_bound.
+    bool
+    has_later_generation(QPDFObjGen og) const
+    {
+        if (dense_match(og)) {
+            // A dense slot holds the first generation encountered, which is not necessarily the
+            // lowest one.
+            auto it = sparse_elements.upper_bound(og);
+            return it != sparse_elements.end() && it->first.getObj() == og.getObj();
+        }
+        auto idx = to_idx(og);
+        if (og.getObj() >= 0 && idx < dense.size() && present(idx) &&
+            og.getGen() < dense[idx].first.getGen()) {
+            return true;
+        }
+        auto it = sparse_elements.upper_bound(og);
+        return it != sparse_elements.end() && it->first.getObj() == og.getObj();
+    }
+
+    // Extend the vector to accommodate object ids less than n and move any matching sparse elements
+    // into it. This should be called when the largest legitimate object id becomes known, e.g. after
+    // reading the xref table, since elements inserted while the table is still small end up in
+    // the sparse map. Moving elements invalidates iterators to those elements.
+    void
+    reserve(size_t n)
+    {
+        if (n <= dense.size()) {
+            return;
+        }
+        auto old_size = dense.size();
+        dense.resize(n, value_type(QPDFObjGen(0, absent_gen), T()));
+        auto it = sparse_elements.lower_bound(QPDFObjGen(static_cast<int>(old_size), 0));
+        while (it != sparse_elements.end() && to_idx(it->first) < n) {
+            auto i = to_idx(it->first);
+            if (present(i)) {
+                ++it;
+            } else {
+                dense[i] = std::move(it->second);
+                dense_last = std::max(dense_last, i);
+                it = sparse_elements.erase(it);
+            }
+        }
+    }
+
+  private:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+    static constexpr int absent_gen = -1;
+
+    static size_t
+    to_idx(QPDFObjGen og)
+    {
+        return og.getObj() < 0 ? npos : static_cast<size_t>(og.getObj());
+    }
+
+    bool
+    present(size_t idx) const
+    {
+        return dense[idx].first.getGen() != absent_gen;
+    }
+
+    bool
+    dense_match(QPDFObjGen og) const
+    {
+        auto idx = to_idx(og);
+        return idx < dense.size() && dense[idx].first == og;
+    }
+
+    size_t
+    next_dense(size_t idx) const
+    {
+        while (idx < dense.size() && !present(idx)) {
+            ++idx;
+        }
+        return idx < dense.size() ? idx : npos;
+    }
+
+    // Return the index of the first dense element with a key greater than og.
+    size_t
+    next_dense(QPDFObjGen og) const
+    {
+        auto idx = to_idx(og);
+        if (idx == npos) {
+            return next_dense(0);
+        }
+        if (idx < dense.size() && present(idx) && og < dense[idx].first) {
+            return idx;
+        }
+        return idx + 1 < dense.size() ? next_dense(idx + 1) : npos;
+    }
+
+    // Keep the vector at least half full.
+    size_t
+    max_dense_size() const
+    {
+        return 2 * count + 64;
+    }
+
+    // Extend the vector without moving sparse elements. This keeps iterators to sparse elements
+    // valid.
+    void
+    grow(size_t idx)
+    {
+        auto new_size = std::min(std::max(idx + 1, 2 * dense.size()), max_dense_size());
+        dense.resize(new_size, value_type(QPDFObjGen(0, absent_gen), T()));
+    }
+
+    void
+    erase_dense(size_t idx)
+    {
+        dense[idx] = value_type(QPDFObjGen(0, absent_gen), T());
+        --count;
+        while (dense_last > 0 && !present(dense_last)) {
+            --dense_last;
+        }
+    }
+
+    std::vector<value_type> dense;
+    sparse_map sparse_elements;
+    size_t count{0};
+    // Largest index of a present element in dense, or 0 if there is none.
+    size_t dense_last{0};
+};
+
+#endif // OBJGENTABLE_HH
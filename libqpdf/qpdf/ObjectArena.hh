@@ -0,0 +1,200 @@
+#ifndef OBJECTARENA_HH
+#define OBJECTARENA_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A pool allocator for QPDFObject instances. Objects created with QPDFObject::create_in are
+// allocated, together with their shared_ptr control blocks, from large chunks of memory owned by the
+// arena. This avoids one call to malloc and free per object and the per-allocation overhead of the
+// general purpose allocator. Freed blocks are kept on a free list and reused for new objects.
+//
+// The arena is reference counted. It is kept alive by its owner (a QPDF object) and by every live
+// allocation, so object handles may safely outlive the QPDF object. The memory is released in
+// bulk when the owner and all allocations are gone.
+//
+// The arena is not thread-safe. All objects allocated from an arena must be created and destroyed
+// on the same thread.
+class ObjectArena
+{
+  public:
+    // RAII holder of the owner's reference to an arena.
+    class Owner
+    {
+      public:
+        Owner() = default;
+        Owner(Owner const&) = delete;
+        Owner& operator=(Owner const&) = delete;
+        ~Owner()
+        {
+            reset();
+        }
+
+        void
+        create()
+        {
+            if (!arena) {
+                arena = new ObjectArena;
+            }
+        }
+
+        void
+        reset()
+        {
+            if (arena) {
+                arena->owned = false;
+                arena->release_if_unused();
+                arena = nullptr;
+            }
+        }
+
+        ObjectArena*
+        get() const
+        {
+            return arena;
+        }
+
+      private:
+        ObjectArena* arena{nullptr};
+    };
+
+    // Minimal allocator for use with std::allocate_shared.
+    template <class T>
+    class Allocator
+    {
+      public:
+        using value_type = T;
+
+        explicit Allocator(ObjectArena* arena) :
+            arena(arena)
+        {
+        }
+
+        template <class U>
+        Allocator(Allocator<U> const& other) :
+            arena(other.arena)
+        {
+        }
+
+        T*
+        allocate(size_t n)
+        {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void
+        deallocate(T* p, size_t n)
+        {
+            arena->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template <class U>
+        bool
+        operator==(Allocator<U> const& other) const
+        {
+            return arena == other.arena;
+        }
+
+      private:
+        template <class U>
+        friend class Allocator;
+
+        ObjectArena* arena;
+    };
+
+    ObjectArena(ObjectArena const&) = delete;
+    ObjectArena& operator=(ObjectArena const&) = delete;
+
+  private:
+    ObjectArena() = default;
+    ~ObjectArena() = default;
+
+    // All blocks served from the chunks have the same size and alignment, which are those of the
+    // first allocation. Since the arena is only used to allocate shared QPDFObjects, this is the
+    // size of a control block including the QPDFObject. Unlike operator new, the arena only aligns
+    // blocks as required by their type rather than to __STDCPP_DEFAULT_NEW_ALIGNMENT__, which
+    // saves a few bytes per object. Any allocations of a different size or alignment are passed on
+    // to operator new.
+    void*
+    allocate(size_t size, size_t align)
+    {
+        ++live;
+        if (block_size == 0) {
+            alignment = std::max(align, alignof(Free));
+            block_size = (std::max(size, sizeof(Free)) + alignment - 1) / alignment * alignment;
+        }
+        if (!fits(size, align)) {
+            return ::operator new(size);
+        }
+        if (!free_list) {
+            add_chunk();
+        }
+        auto block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    void
+    deallocate(void* p, size_t size, size_t align)
+    {
+        if (!fits(size, align)) {
+            ::operator delete(p);
+        } else {
+            auto block = static_cast<Free*>(p);
+            block->next = free_list;
+            free_list = block;
+        }
+        --live;
+        release_if_unused();
+    }
+
+    bool
+    fits(size_t size, size_t align) const
+    {
+        return size <= block_size && block_size - size < alignment && align <= alignment;
+    }
+
+    void
+    add_chunk()
+    {
+        // Start with small chunks so that small files don't pay for a large arena, and keep the
+        // chunks small enough that the unused tail of the last chunk doesn't matter.
+        auto n_blocks = initial_chunk_blocks << std::min(chunks.size(), max_chunk_doublings);
+        chunks.emplace_back(new std::byte[n_blocks * block_size]);
+        auto start = chunks.back().get();
+        for (size_t i = n_blocks; i > 0; --i) {
+            auto block = reinterpret_cast<Free*>(start + (i - 1) * block_size);
+            block->next = free_list;
+            free_list = block;
+        }
+    }
+
+    void
+    release_if_unused()
+    {
+        if (!owned && live == 0) {
+            delete this;
+        }
+    }
+
+    struct Free
+    {
+        Free* next;
+    };
+
+    static constexpr size_t initial_chunk_blocks = 256;
+    static constexpr size_t max_chunk_doublings = 4;
+
+    bool owned{true};
+    size_t live{0};
+    size_t block_size{0};
+    size_t alignment{0};
+    Free* free_list{nullptr};
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+};
+
+#endif // OBJECTARENA_HH
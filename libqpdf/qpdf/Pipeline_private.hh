@@ -99,6 +99,15 @@ namespace qpdf::pl
 
         ~Count() final = default;
 
+        // Collect up to 'size' bytes before passing them to 'next' rather than passing on each
+        // write as it happens. This only has an effect if 'next' was given to the constructor.
+        void
+        buffer(size_t size)
+        {
+            buffer_size = size;
+            buffered.reserve(size);
+        }
+
         void
         write(unsigned char const* buf, size_t len) final
         {
@@ -109,7 +118,16 @@ namespace qpdf::pl
                 }
                 count += static_cast<qpdf_offset_t>(len);
                 if (pass_immediately_to_next) {
-                    next()->write(buf, len);
+                    if (buffered.size() + len <= buffer_size) {
+                        buffered.append(reinterpret_cast<char const*>(buf), len);
+                        return;
+                    }
+                    flush();
+                    if (len < buffer_size) {
+                        buffered.append(reinterpret_cast<char const*>(buf), len);
+                    } else {
+                        next()->write(buf, len);
+                    }
                 }
             }
         }
@@ -120,6 +138,8 @@ namespace qpdf::pl
             if (next()) {
                 if (!pass_immediately_to_next) {
                     next()->write(reinterpret_cast<unsigned char const*>(str->data()), str->size());
+                } else {
+                    flush();
                 }
                 next()->finish();
             }
@@ -138,7 +158,19 @@ namespace qpdf::pl
         }
 
       private:
+        void
+        flush()
+        {
+            if (!buffered.empty()) {
+                next()->write(
+                    reinterpret_cast<unsigned char const*>(buffered.data()), buffered.size());
+                buffered.clear();
+            }
+        }
+
         qpdf_offset_t count{0};
+        size_t buffer_size{0};
+        std::string buffered;
         std::string* str{nullptr};
         std::unique_ptr<Link> link{nullptr};
         unsigned long id_{0};
@@ -0,0 +1,67 @@
+#ifndef PL_SPILLBUFFER_HH
+#define PL_SPILLBUFFER_HH
+
+#include <qpdf/Pipeline.hh>
+
+#include <cstdio>
+#include <string>
+
+// This pipeline collects the data written to it. Data is kept in memory until more than
+// memory_limit bytes have been written, at which point everything written so far and all
+// subsequent data is moved to an anonymous temporary file. A memory limit of 0 means that all data
+// is kept in memory. The collected data may be sent to another pipeline with writeTo, which may be
+// called any number of times.
+
+// This pipeline is reusable; i.e., it is safe to call write() after calling finish(). Data written
+// after finish() is appended to the data already collected. Call clear() to discard the data.
+class Pl_SpillBuffer final: public Pipeline
+{
+  public:
+    Pl_SpillBuffer(char const* identifier, size_t memory_limit);
+    ~Pl_SpillBuffer() final;
+    void write(unsigned char const*, size_t) final;
+    void finish() final;
+
+    // Replace the collected data with str, which is kept in memory regardless of its size.
+    void assign(std::string&& str);
+    void clear();
+    // Write the collected data to p without calling finish() on p.
+    void writeTo(Pipeline& p);
+    // Return the collected data as a string. This may only be called if the data has not been
+    // moved to a temporary file. The data is moved out of the pipeline.
+    std::string getString();
+
+    size_t
+    size() const
+    {
+        return file ? file_size : data.size();
+    }
+    bool
+    empty() const
+    {
+        return size() == 0;
+    }
+    // Return the last character written, or '\0' if no data has been written.
+    char
+    back() const
+    {
+        return last_char;
+    }
+    // Return true if the data has been moved to a temporary file.
+    bool
+    spilled() const
+    {
+        return file != nullptr;
+    }
+
+  private:
+    void spill();
+
+    size_t memory_limit;
+    std::string data;
+    FILE* file{nullptr};
+    size_t file_size{0};
+    char last_char{'\0'};
+};
+
+#endif // PL_SPILLBUFFER_HH
@@ -61,11 +61,10 @@ namespace qpdf
     class BaseDictionary: public BaseHandle
     {
       public:
-        using iterator = std::map<std::string, QPDFObjectHandle>::iterator;
-        using const_iterator = std::map<std::string, QPDFObjectHandle>::const_iterator;
-        using reverse_iterator = std::map<std::string, QPDFObjectHandle>::reverse_iterator;
-        using const_reverse_iterator =
-            std::map<std::string, QPDFObjectHandle>::const_reverse_iterator;
+        using iterator = QPDF_Dictionary::Items::iterator;
+        using const_iterator = QPDF_Dictionary::Items::const_iterator;
+        using reverse_iterator = QPDF_Dictionary::Items::reverse_iterator;
+        using const_reverse_iterator = QPDF_Dictionary::Items::const_reverse_iterator;
 
         iterator
         begin()
@@ -143,7 +142,7 @@ namespace qpdf
         bool hasKey(std::string const& key) const;
         QPDFObjectHandle getKey(std::string const& key) const;
         std::set<std::string> getKeys();
-        std::map<std::string, QPDFObjectHandle> const& getAsMap() const;
+        std::map<std::string, QPDFObjectHandle> getAsMap() const;
         void removeKey(std::string const& key);
         void replaceKey(std::string const& key, QPDFObjectHandle value);
 
@@ -222,6 +221,7 @@ namespace qpdf
         setFilterOnWrite(bool val)
         {
             stream()->filter_on_write = val;
+            obj->modified();
         }
         bool
         getFilterOnWrite() const
@@ -246,6 +246,11 @@ namespace qpdf
             return stream()->stream_provider;
         }
 
+        // For use as an encode flag with pipeStreamData together with qpdf_ef_compress. Filter the
+        // stream as for qpdf_ef_compress, but don't compress the data. This allows the caller to
+        // compress it separately.
+        static constexpr int ef_filter_only = 1 << 16;
+
         // See comments in QPDFObjectHandle.hh for these methods.
         bool pipeStreamData(
             Pipeline* p,
@@ -256,6 +261,17 @@ namespace qpdf
             bool will_retry);
         std::shared_ptr<Buffer> getStreamData(qpdf_stream_decode_level_e level);
         std::shared_ptr<Buffer> getRawStreamData();
+        // Return true if the stream's data is the unmodified data of an unencrypted input file, in
+        // which case copyRawStreamData writes getLength() bytes of raw data to p, reading them
+        // directly from the input file, and does not call finish() on p.
+        bool canCopyRawStreamData() const;
+        void copyRawStreamData(Pipeline* p) const;
+        // Populate filters with the filters needed to decode the stream at decode_level. Return
+        // false if the stream can't be decoded at that level.
+        bool filterable(
+            qpdf_stream_decode_level_e decode_level,
+            std::vector<std::shared_ptr<QPDFStreamFilter>>& filters,
+            bool suppress_warnings = false);
         void replaceStreamData(
             std::shared_ptr<Buffer> data,
             QPDFObjectHandle const& filter,
@@ -268,6 +284,7 @@ namespace qpdf
         addTokenFilter(std::shared_ptr<QPDFObjectHandle::TokenFilter> token_filter)
         {
             stream()->token_filters.emplace_back(token_filter);
+            obj->modified();
         }
         JSON getStreamJSON(
             int json_version,
@@ -287,6 +304,7 @@ namespace qpdf
         replaceDict(QPDFObjectHandle const& new_dict)
         {
             auto s = stream();
+            obj->modified();
             s->stream_dict = new_dict;
             setDictDescription();
         }
@@ -311,9 +329,6 @@ namespace qpdf
             throw std::runtime_error("operation for stream attempted on non-stream object");
             return nullptr; // unreachable
         }
-        bool filterable(
-            qpdf_stream_decode_level_e decode_level,
-            std::vector<std::shared_ptr<QPDFStreamFilter>>& filters);
         void replaceFilterData(
             QPDFObjectHandle const& filter, QPDFObjectHandle const& decode_parms, size_t length);
 
@@ -401,9 +416,10 @@ namespace qpdf
 
 } // namespace qpdf
 
-inline QPDF_Dictionary::QPDF_Dictionary(std::map<std::string, QPDFObjectHandle>&& items) :
+inline QPDF_Dictionary::QPDF_Dictionary(Items&& items) :
     items(std::move(items))
 {
+    this->items.shrink_to_fit();
 }
 
 inline std::shared_ptr<QPDFObject>
@@ -427,6 +443,17 @@ QPDFObject::create(Args&&... args)
     return std::make_shared<QPDFObject>(std::forward<T>(T(std::forward<Args>(args)...)));
 }
 
+template <typename T, typename... Args>
+inline std::shared_ptr<QPDFObject>
+QPDFObject::create_in(ObjectArena* arena, Args&&... args)
+{
+    if (!arena) {
+        return create<T>(std::forward<Args>(args)...);
+    }
+    return std::allocate_shared<QPDFObject>(
+        ObjectArena::Allocator<QPDFObject>(arena), std::forward<T>(T(std::forward<Args>(args)...)));
+}
+
 inline qpdf_object_type_e
 QPDFObject::getResolvedTypeCode() const
 {
@@ -4,9 +4,12 @@
 // NOTE: This file is called QPDFObject_private.hh instead of QPDFObject.hh because of
 // include/qpdf/QPDFObject.hh. See comments there for an explanation.
 
+#include <qpdf/CompactMap.hh>
 #include <qpdf/Constants.h>
+#include <qpdf/InternedName.hh>
 #include <qpdf/JSON.hh>
 #include <qpdf/JSON_writer.hh>
+#include <qpdf/ObjectArena.hh>
 #include <qpdf/QPDF.hh>
 #include <qpdf/QPDFObjGen.hh>
 #include <qpdf/Types.h>
@@ -98,13 +101,21 @@ class QPDF_Dictionary final
     friend class qpdf::BaseDictionary;
     friend class qpdf::BaseHandle;
 
+  public:
+    using Items = CompactMap<InternedName, QPDFObjectHandle>;
+
+  private:
     QPDF_Dictionary(std::map<std::string, QPDFObjectHandle> const& items) :
         items(items)
     {
     }
-    inline QPDF_Dictionary(std::map<std::string, QPDFObjectHandle>&& items);
+    QPDF_Dictionary(Items const& items) :
+        items(items)
+    {
+    }
+    inline QPDF_Dictionary(Items&& items);
 
-    std::map<std::string, QPDFObjectHandle> items;
+    Items items;
 };
 
 class QPDF_InlineImage final
@@ -136,12 +147,17 @@ class QPDF_Name final
 {
     friend class QPDFObject;
     friend class qpdf::BaseHandle;
+    friend class QPDFObjectHandle;
 
-    explicit QPDF_Name(std::string name) :
+    explicit QPDF_Name(std::string_view name) :
+        name(name)
+    {
+    }
+    explicit QPDF_Name(InternedName name) :
         name(std::move(name))
     {
     }
-    std::string name;
+    InternedName name;
 };
 
 class QPDF_Null final
@@ -301,6 +317,24 @@ class QPDFObject
             qpdf, og, std::forward<T>(T(std::forward<Args>(args)...)));
     }
 
+    // As create, but allocate the object from arena unless arena is null.
+    template <typename T, typename... Args>
+    inline static std::shared_ptr<QPDFObject> create_in(ObjectArena* arena, Args&&... args);
+
+    template <typename T, typename... Args>
+    inline static std::shared_ptr<QPDFObject>
+    create_in(ObjectArena* arena, QPDF* qpdf, QPDFObjGen og, Args&&... args)
+    {
+        if (!arena) {
+            return create<T>(qpdf, og, std::forward<Args>(args)...);
+        }
+        return std::allocate_shared<QPDFObject>(
+            ObjectArena::Allocator<QPDFObject>(arena),
+            qpdf,
+            og,
+            std::forward<T>(T(std::forward<Args>(args)...)));
+    }
+
     std::string getStringValue() const;
 
     // Return a unique type code for the resolved object
@@ -342,6 +376,9 @@ class QPDFObject
         std::swap(parsed_offset, o->parsed_offset);
     }
 
+    // Must be called before the value of the object is changed in place.
+    void modified();
+
     void
     setObjGen(QPDF* a_qpdf, QPDFObjGen a_og)
     {
@@ -446,6 +483,13 @@ class QPDFObject
     {
         return parsed_offset;
     }
+    // All objects created by one parse share their description, so it identifies the indirect
+    // object that contains a direct object read from a file.
+    Description const*
+    getSharedDescription() const
+    {
+        return object_description.get();
+    }
     QPDF*
     getQPDF()
     {
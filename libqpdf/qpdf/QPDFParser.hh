@@ -16,7 +16,7 @@ class QPDFParser
     parse(InputSource& input, std::string const& object_description, QPDF* context);
 
     static QPDFObjectHandle parse_content(
-        InputSource& input,
+        qpdf::is::OffsetBuffer& input,
         std::shared_ptr<QPDFObject::Description> sp_description,
         qpdf::Tokenizer& tokenizer,
         QPDF* context);
@@ -71,6 +71,7 @@ class QPDFParser
         tokenizer(tokenizer),
         decrypter(decrypter),
         context(context),
+        arena(context ? QPDF::ParseGuard::arena(context) : nullptr),
         description(std::move(sp_description)),
         parse_pdf(parse_pdf),
         stream_id(stream_id),
@@ -79,6 +80,29 @@ class QPDFParser
     {
     }
 
+    // Parse PDF syntax from a memory-backed input source, reading tokens directly from memory.
+    QPDFParser(
+        qpdf::is::OffsetBuffer& input,
+        std::shared_ptr<QPDFObject::Description> sp_description,
+        std::string const& object_description,
+        qpdf::Tokenizer& tokenizer,
+        QPDF* context,
+        int stream_id = 0,
+        int obj_id = 0) :
+        QPDFParser(
+            input,
+            std::move(sp_description),
+            object_description,
+            tokenizer,
+            nullptr,
+            context,
+            true,
+            stream_id,
+            obj_id)
+    {
+        buffer = &input;
+    }
+
     // Parser state.  Note:
     // state <= st_dictionary_value == (state = st_dictionary_key || state = st_dictionary_value)
     enum parser_state_e { st_dictionary_key, st_dictionary_value, st_array };
@@ -92,7 +116,7 @@ class QPDFParser
         }
 
         std::vector<QPDFObjectHandle> olist;
-        std::map<std::string, QPDFObjectHandle> dict;
+        QPDF_Dictionary::Items dict;
         parser_state_e state;
         std::string key;
         qpdf_offset_t offset;
@@ -102,6 +126,7 @@ class QPDFParser
     };
 
     QPDFObjectHandle parse(bool& empty, bool content_stream);
+    bool nextToken();
     QPDFObjectHandle parseRemainder(bool content_stream);
     void add(std::shared_ptr<QPDFObject>&& obj);
     void addNull();
@@ -120,10 +145,13 @@ class QPDFParser
     QPDFObjectHandle withDescription(Args&&... args);
     void setDescription(std::shared_ptr<QPDFObject>& obj, qpdf_offset_t parsed_offset);
     InputSource& input;
+    // Set if input is memory-backed, in which case tokens are read directly from memory.
+    qpdf::is::OffsetBuffer* buffer{nullptr};
     std::string const& object_description;
     qpdf::Tokenizer& tokenizer;
     QPDFObjectHandle::StringDecrypter* decrypter;
     QPDF* context;
+    ObjectArena* arena;
     std::shared_ptr<QPDFObject::Description> description;
     bool parse_pdf{false};
     int stream_id{0};
@@ -3,6 +3,13 @@
 
 #include <qpdf/QPDFTokenizer.hh>
 
+#include <string_view>
+
+namespace qpdf::is
+{
+    class OffsetBuffer;
+}
+
 namespace qpdf
 {
 
@@ -54,6 +61,9 @@ namespace qpdf
         // an error message for any reason.
         bool nextToken(InputSource& input, std::string const& context, size_t max_len = 0);
 
+        // As above, but read directly from the memory of the input source.
+        bool nextToken(is::OffsetBuffer& input, std::string const& context, size_t max_len = 0);
+
         // The following methods are only valid after nextToken has been called and until another
         // QPDFTokenizer method is called. They allow the results of calling nextToken to be
         // accessed without creating a Token, thus avoiding copying information that may not be
@@ -86,6 +96,9 @@ namespace qpdf
         bool isSpace(char);
         bool isDelimiter(char);
         void findEI(InputSource& input);
+        size_t consumeRun(std::string_view buf);
+        template <typename Reader>
+        bool scanToken(Reader& reader, size_t max_len);
 
         enum state_e {
             st_top,
@@ -5,6 +5,12 @@
 
 #include <qpdf/ObjTable.hh>
 #include <qpdf/Pipeline_private.hh>
+#include <qpdf/ThreadPool.hh>
+
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <future>
 
 // This file is intended for inclusion by QPDFWriter, QPDF, QPDF_optimization and QPDF_linearization
 // only.
@@ -55,6 +61,40 @@ class QPDFWriter::Members
     Members(QPDF& pdf);
     Members(Members const&) = delete;
 
+    // Stream data retrieved ahead of time while compressing on worker threads.
+    struct PreparedStream
+    {
+        bool filtered{false};
+        bool compress{false};
+        bool is_metadata{false};
+        // The data to write if it is not being compressed.
+        std::string data;
+        // The compressed data if it is being compressed.
+        std::future<std::string> compressed;
+    };
+
+    // An object stream that is being compressed on a worker thread. The objects that come after it
+    // in the output are written to a buffer until the object stream can be written.
+    struct PendingObjectStream
+    {
+        QPDFObjectHandle object;
+        qpdf_offset_t first{0};
+        std::future<std::string> compressed;
+        std::string following;
+        // New object ids of objects in following, whose offsets are relative to following
+        std::vector<int> following_ids;
+    };
+
+    // The bytes of an object written in the first pass of linearization, which are written again
+    // in the second pass. The offsets of the objects in ids are kept in new_obj.
+    struct CachedObject
+    {
+        std::string data;
+        std::vector<int> ids;
+        qpdf_offset_t offset{0};
+        int events{0};
+    };
+
     QPDF& pdf;
     QPDFObjGen root_og{-1, 0};
     char const* filename{"unspecified"};
@@ -79,6 +119,7 @@ class QPDFWriter::Members
     bool preserve_encryption{true};
     bool linearized{false};
     bool pclm{false};
+    bool incremental{false};
     qpdf_object_stream_e object_stream_mode{qpdf_o_preserve};
     std::string encryption_key;
     bool encrypt_metadata{true};
@@ -121,14 +162,43 @@ class QPDFWriter::Members
     std::string deterministic_id_data;
     bool did_write_setup{false};
 
+    // For the unparsed object cache: the references of the object being unparsed are recorded here
+    std::vector<std::pair<QPDFObjGen, int>>* unparsed_references{nullptr};
+    bool unparsed_cacheable{false};
+
+    // For compressing stream data on worker threads
+    size_t compression_threads{1};
+    std::unique_ptr<ThreadPool> compression_pool;
+    std::map<QPDFObjGen, PreparedStream> prepared_streams;
+    size_t prepare_front{0};
+    std::deque<PendingObjectStream> pending_object_streams;
+
+    // Data of streams larger than this is moved to a temporary file while it is being written.
+    size_t buffer_memory_limit{0};
+
+    // Output is collected in the bottom pipeline of the stack up to this size.
+    size_t output_buffer_size{0};
+    bool sync_output{false};
+
+    // Identical objects are merged before writing.
+    bool deduplicate_objects{false};
+
     // For linearization only
     std::string lin_pass1_filename;
+    bool linearization_object_cache{false};
 
     // For progress reporting
     std::shared_ptr<QPDFWriter::ProgressReporter> progress_reporter;
     int events_expected{0};
     int events_seen{0};
     int next_progress_report{0};
+
+    // For statistics
+    bool collect_statistics{false};
+    QPDFWriter::Statistics statistics;
+    char const* phase{nullptr};
+    std::chrono::steady_clock::time_point phase_wall_start;
+    std::clock_t phase_cpu_start{0};
 };
 
 #endif // QPDFWRITER_PRIVATE_HH
@@ -3,6 +3,9 @@
 
 #include <qpdf/QPDF.hh>
 
+#include <qpdf/ObjGenTable.hh>
+#include <qpdf/ObjectArena.hh>
+
 #include <qpdf/QPDFObject_private.hh>
 #include <qpdf/QPDFTokenizer_private.hh>
 
@@ -59,10 +62,18 @@ class QPDF::Writer
         return qpdf.getCompressibleObjSet();
     }
 
-    static std::map<QPDFObjGen, QPDFXRefEntry> const&
-    getXRefTable(QPDF& qpdf)
+    static ObjGenTable<QPDFXRefEntry> const& getXRefTable(QPDF& qpdf);
+
+    static qpdf_offset_t
+    copyInputFile(QPDF& qpdf, Pipeline* pipeline)
+    {
+        return qpdf.copyInputFile(pipeline);
+    }
+
+    static std::vector<QPDFObjGen>
+    getChangedObjects(QPDF& qpdf)
     {
-        return qpdf.getXRefTableInternal();
+        return qpdf.getChangedObjects();
     }
 
     static size_t
@@ -70,6 +81,11 @@ class QPDF::Writer
     {
         return qpdf.tableSize();
     }
+
+    static bool unparsedObjectCache(QPDF& qpdf);
+    static UnparsedObject const*
+    getUnparsedObject(QPDF& qpdf, QPDFObjGen og, std::string const& settings);
+    static void setUnparsedObject(QPDF& qpdf, QPDFObjGen og, UnparsedObject&& unparsed);
 };
 
 // The Resolver class is restricted to QPDFObject so that only it can resolve indirect
@@ -85,6 +101,9 @@ class QPDF::Resolver
     {
         return qpdf->resolve(og);
     }
+
+    // Record that an object is being modified.
+    static void modified(QPDF* qpdf, QPDFObject& object);
 };
 
 // StreamCopier class is restricted to QPDFObjectHandle so it can copy stream data.
@@ -121,6 +140,8 @@ class QPDF::ParseGuard
         return qpdf->getObjectForParser(id, gen, parse_pdf);
     }
 
+    static ObjectArena* arena(QPDF* qpdf);
+
     ~ParseGuard()
     {
         if (qpdf) {
@@ -151,6 +172,18 @@ class QPDF::Pipe
         return qpdf->pipeStreamData(
             og, offset, length, dict, is_root_metadata, pipeline, suppress_warnings, will_retry);
     }
+
+    static bool
+    canCopyStreamData(QPDF* qpdf, qpdf_offset_t offset, size_t length)
+    {
+        return qpdf->canCopyStreamData(offset, length);
+    }
+
+    static void
+    copyStreamData(QPDF* qpdf, qpdf_offset_t offset, size_t length, Pipeline* pipeline)
+    {
+        qpdf->copyStreamData(offset, length, pipeline);
+    }
 };
 
 class QPDF::ObjCache
@@ -170,6 +203,22 @@ class QPDF::ObjCache
     std::shared_ptr<QPDFObject> object;
     qpdf_offset_t end_before_space{0};
     qpdf_offset_t end_after_space{0};
+    // Set if the object was modified after it was read from the file.
+    bool modified{false};
+};
+
+// The bytes written by QPDFWriter for a non-stream object, used by the unparsed object cache.
+class QPDF::UnparsedObject
+{
+  public:
+    // The writer settings that affect the bytes
+    std::string settings;
+    // The value of Members::direct_modifications when the bytes were written
+    unsigned long long direct_modifications{0};
+    std::string data;
+    // The indirect objects referenced by the object in the order they appear, with the object
+    // numbers they were written with
+    std::vector<std::pair<QPDFObjGen, int>> references;
 };
 
 class QPDF::ObjCopier
@@ -470,12 +519,15 @@ class QPDF::Members
     bool check_mode{false};
     std::shared_ptr<EncryptionParameters> encp;
     std::string pdf_version;
-    std::map<QPDFObjGen, QPDFXRefEntry> xref_table;
+    ObjGenTable<QPDFXRefEntry> xref_table;
     // Various tables are indexed by object id, with potential size id + 1
     int xref_table_max_id{std::numeric_limits<int>::max() - 1};
     qpdf_offset_t xref_table_max_offset{0};
+    // Offset of the last cross-reference section, which is the one startxref points to
+    qpdf_offset_t last_xref_offset{0};
+    bool direct_objects_modified{false};
     std::set<int> deleted_objects;
-    std::map<QPDFObjGen, ObjCache> obj_cache;
+    ObjGenTable<ObjCache> obj_cache;
     std::set<QPDFObjGen> resolving;
     QPDFObjectHandle trailer;
     std::vector<QPDFObjectHandle> all_pages;
@@ -493,9 +545,30 @@ class QPDF::Members
     bool in_xref_reconstruction{false};
     bool fixed_dangling_refs{false};
     bool immediate_copy_from{false};
+    bool use_mmap{false};
+    size_t object_stream_decode_threads{1};
+    ObjectArena::Owner object_arena;
     bool in_parse{false};
     bool parsed{false};
     std::set<int> resolved_object_streams;
+    // Object streams decoded ahead of time by resolveObjectStreamsInParallel
+    std::map<int, std::shared_ptr<Buffer>> decoded_object_streams;
+    size_t object_cache_limit{0};
+    // Objects that may be evicted from obj_cache by trimObjectCache, most recently loaded first
+    std::list<QPDFObjGen> evictable_objects;
+    struct Evictable
+    {
+        std::list<QPDFObjGen>::iterator position;
+        // The description shared by the direct objects that were read with the object
+        QPDFObject::Description const* description{nullptr};
+    };
+    ObjGenTable<Evictable> evictable_positions;
+    // The evictable object that contains the direct objects with each description
+    std::map<QPDFObject::Description const*, QPDFObjGen> direct_object_owners;
+    bool unparsed_object_cache{false};
+    ObjGenTable<UnparsedObject> unparsed_objects;
+    // Incremented whenever a direct object is modified, which invalidates all unparsed objects
+    unsigned long long direct_modifications{0};
 
     // Linearization data
     qpdf_offset_t first_xref_item_offset{0}; // actual value from file
@@ -530,6 +603,75 @@ class QPDF::Members
     std::map<QPDFObjGen, std::set<ObjUser>> object_to_obj_users;
 };
 
+inline ObjectArena*
+QPDF::ParseGuard::arena(QPDF* qpdf)
+{
+    return qpdf->m->object_arena.get();
+}
+
+inline void
+QPDF::Resolver::modified(QPDF* qpdf, QPDFObject& object)
+{
+    auto og = object.getObjGen();
+    if (!og.isIndirect()) {
+        // The indirect object containing a direct object is not generally known, so changed
+        // objects have to be found by comparing them with the input file when writing an
+        // incremental update.
+        qpdf->m->direct_objects_modified = true;
+        ++qpdf->m->direct_modifications;
+        if (qpdf->m->object_cache_limit) {
+            // The object that contains a direct object read from the file must not be evicted, or
+            // the change would be lost.
+            auto& owners = qpdf->m->direct_object_owners;
+            if (auto it = owners.find(object.getSharedDescription()); it != owners.end()) {
+                qpdf->untrackEvictable(it->second);
+            }
+        }
+        return;
+    }
+    if (auto it = qpdf->m->obj_cache.find(og); it != qpdf->m->obj_cache.end()) {
+        it->second.modified = true;
+    }
+    qpdf->m->unparsed_objects.erase(og);
+    if (qpdf->m->object_cache_limit) {
+        // Modified objects must not be evicted.
+        qpdf->untrackEvictable(og);
+    }
+}
+
+inline ObjGenTable<QPDFXRefEntry> const&
+QPDF::Writer::getXRefTable(QPDF& qpdf)
+{
+    if (!qpdf.m->parsed) {
+        throw std::logic_error("QPDF::getXRefTable called before parsing.");
+    }
+    return qpdf.m->xref_table;
+}
+
+inline bool
+QPDF::Writer::unparsedObjectCache(QPDF& qpdf)
+{
+    return qpdf.m->unparsed_object_cache;
+}
+
+inline QPDF::UnparsedObject const*
+QPDF::Writer::getUnparsedObject(QPDF& qpdf, QPDFObjGen og, std::string const& settings)
+{
+    auto it = qpdf.m->unparsed_objects.find(og);
+    if (it == qpdf.m->unparsed_objects.end() || it->second.settings != settings ||
+        it->second.direct_modifications != qpdf.m->direct_modifications) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+inline void
+QPDF::Writer::setUnparsedObject(QPDF& qpdf, QPDFObjGen og, UnparsedObject&& unparsed)
+{
+    unparsed.direct_modifications = qpdf.m->direct_modifications;
+    qpdf.m->unparsed_objects[og] = std::move(unparsed);
+}
+
 // JobSetter class is restricted to QPDFJob.
 class QPDF::JobSetter
 {
@@ -542,6 +684,14 @@ class QPDF::JobSetter
     {
         qpdf.m->check_mode = val;
     }
+
+    // Return the indirect objects used by each page, including the page's thumbnail image, without
+    // crossing into other pages.
+    static std::vector<std::set<QPDFObjGen>>
+    getPageObjects(QPDF& qpdf)
+    {
+        return qpdf.getPageObjects();
+    }
 };
 
 class QPDF::ResolveRecorder
@@ -0,0 +1,109 @@
+#ifndef THREADPOOL_HH
+#define THREADPOOL_HH
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// A minimal fixed-size pool of worker threads. Tasks are started in the order in which they are
+// submitted. The destructor waits for all submitted tasks to complete.
+//
+// Tasks run concurrently with the submitting thread, so they must not touch anything that isn't
+// thread-safe. In particular, QPDF and QPDFObjectHandle objects must only be used by the thread
+// that owns them. The usual pattern is to gather input on the owning thread, do the expensive
+// self-contained work (e.g. decompression) in tasks, and integrate the results on the owning
+// thread.
+class ThreadPool
+{
+  public:
+    // Create a pool with n_threads worker threads. If n_threads is 0, use one thread per hardware
+    // thread.
+    explicit ThreadPool(size_t n_threads)
+    {
+        if (n_threads == 0) {
+            n_threads = hardware_threads();
+        }
+        workers.reserve(n_threads);
+        for (size_t i = 0; i < n_threads; ++i) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    size_t
+    size() const
+    {
+        return workers.size();
+    }
+
+    // Queue f for execution. Any exception thrown by f is rethrown by the returned future's get
+    // method.
+    template <class F>
+    std::future<std::invoke_result_t<std::decay_t<F>>>
+    submit(F&& f)
+    {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        auto result = task->get_future();
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    static size_t
+    hardware_threads()
+    {
+        auto n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+  private:
+    void
+    run()
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::queue<std::function<void()>> tasks;
+    bool stopping{false};
+    std::vector<std::thread> workers;
+};
+
+#endif // THREADPOOL_HH
@@ -35,6 +35,22 @@ Specify the name of a file whose contents are expected to
 contain a QPDFJob JSON file. Run qpdf --job-json-help for a
 description of the JSON input file format.
 )");
+ap.addOptionHelp("--job-list", "usage", "run many jobs from a JSON job list", R"(--job-list=file
+
+Run each job in the given JSON file and write a JSON summary of
+the results to standard output. The file contains an object
+whose "jobs" key is an array of QPDFJob JSON objects and whose
+optional "options" key is an object with keys to add to every
+job. Use --threads to run jobs in parallel.
+)");
+ap.addOptionHelp("--serve", "usage", "run jobs sent to a Unix domain socket", R"(--serve=socket
+
+Listen on the Unix domain socket socket and run the jobs sent
+to it until asked to stop. Each request has the same format as
+the file given to --job-list, and the response is the JSON
+summary that --job-list would write. Use --threads to handle
+requests in parallel.
+)");
 ap.addHelpTopic("exit-status", "meanings of qpdf's exit codes", R"(Meaning of exit codes:
 
 - 0: no errors or warnings
@@ -81,6 +97,9 @@ activate it by setting the ``QPDF_ZOPFLI`` environment variable.
 ap.addHelpTopic("general", "general options", R"(General options control qpdf's behavior in ways that are not
 directly related to the operation it is performing.
 )");
+}
+static void add_help_2(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--password", "general", "password for encrypted file", R"(--password=password
 
 Specify a password for an encrypted, password-protected file.
@@ -91,15 +110,19 @@ ap.addOptionHelp("--password-file", "general", "read password from a file", R"(-
 The first line of the specified file is used as the password.
 This is used in place of the --password option.
 )");
-}
-static void add_help_2(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--verbose", "general", "print additional information", R"(Output additional information about various things qpdf is
 doing, including information about files created and operations
 performed.
 )");
 ap.addOptionHelp("--progress", "general", "show progress when writing", R"(Indicate progress when writing files.
 )");
+ap.addOptionHelp("--write-statistics", "general", "write timing and stream statistics as JSON", R"(--write-statistics=file
+
+Write statistics about writing the output file to the named
+file as JSON. The statistics include the time spent in each
+phase of writing and what was done with the data of each kind
+of stream.
+)");
 ap.addOptionHelp("--no-warn", "general", "suppress printing of warning messages", R"(Suppress printing of warning messages. If warnings were
 encountered, qpdf still exits with exit status 3.
 Use --warning-exit-0 with --no-warn to completely ignore
@@ -148,11 +171,56 @@ cross reference table or stream lengths.
 ap.addOptionHelp("--ignore-xref-streams", "advanced-control", "use xref tables rather than streams", R"(Ignore any cross-reference streams in the file, falling back to
 cross-reference tables or triggering document recovery.
 )");
+ap.addOptionHelp("--use-mmap", "advanced-control", "map input files into memory", R"(Read input files by mapping them into memory rather than
+through ordinary file I/O. Falls back to ordinary file I/O
+if a file can't be mapped.
+)");
+ap.addOptionHelp("--use-object-arena", "advanced-control", "allocate objects from a memory pool", R"(Allocate objects read from input files from a memory pool
+instead of individually. This reduces memory use and speeds up
+reading files with many objects.
+)");
+ap.addOptionHelp("--object-cache-limit", "advanced-control", "limit objects kept in memory", R"(--object-cache-limit=count
+
+Keep at most about count objects from the input file in memory
+while checking the file or writing output. Objects that are
+evicted are read again when needed. 0 means no limit.
+)");
+}
+static void add_help_3(QPDFArgParser& ap)
+{
+ap.addOptionHelp("--buffer-memory-limit", "advanced-control", "limit memory used for stream data when writing", R"(--buffer-memory-limit=bytes
+
+Keep at most bytes bytes of the data of a stream or object
+stream in memory while writing it, moving the rest to a
+temporary file. 0 means no limit.
+)");
+ap.addOptionHelp("--output-buffer-size", "advanced-control", "buffer output before writing it", R"(--output-buffer-size=bytes
+
+Collect up to bytes bytes of output before writing it to the
+output file. 0, the default, writes output as it is produced.
+)");
+ap.addOptionHelp("--sync-output", "advanced-control", "write output file to storage before exiting", R"(Flush the output file and wait for the operating system to write
+it to storage before qpdf exits.
+)");
+ap.addOptionHelp("--threads", "advanced-control", "use worker threads", R"(--threads=count
+
+Use up to count worker threads for work that can be done in
+parallel. 0 means one thread per CPU. The default is 1.
+)");
 ap.addHelpTopic("transformation", "make structural PDF changes", R"(The options below tell qpdf to apply transformations that change
 the structure without changing the content.
 )");
 ap.addOptionHelp("--linearize", "transformation", "linearize (web-optimize) output", R"(Create linearized (web-optimized) output files.
 )");
+ap.addOptionHelp("--linearize-cache", "transformation", "keep objects in memory while linearizing", R"(When linearizing, keep the objects written in the first pass
+in memory and reuse them in the second pass. This is faster
+but uses memory proportional to the size of the output.
+)");
+ap.addOptionHelp("--incremental-update", "transformation", "append changes to a copy of the input file", R"(Write the output as an incremental update: an unchanged copy
+of the input file followed by only the objects that were added
+or changed. This keeps digital signatures valid and is much
+faster for large files with few changes.
+)");
 ap.addOptionHelp("--encrypt", "transformation", "start encryption options", R"(--encrypt [options] --
 
 Run qpdf --help=encryption for details.
@@ -173,9 +241,6 @@ Copy encryption details from the specified file instead of
 preserving the input file's encryption. Use --encryption-file-password
 to specify the encryption file's password.
 )");
-}
-static void add_help_3(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--encryption-file-password", "transformation", "supply password for --copy-encryption", R"(--encryption-file-password=password
 
 If the file named in --copy-encryption requires a password, use
@@ -231,6 +296,9 @@ leaves these alone. This option tells qpdf to uncompress and
 recompress streams compressed with flate. This can be useful
 when combined with --compression-level.
 )");
+}
+static void add_help_4(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--compression-level", "transformation", "set compression level for flate", R"(--compression-level=level
 
 Set a compression level from 1 (least, fastest) to 9 (most,
@@ -261,6 +329,9 @@ Control what qpdf does regarding object streams. Options:
 - disable: create output files with no object streams
 - generate: create object streams, and compress objects when possible
 )");
+ap.addOptionHelp("--deduplicate-objects", "transformation", "merge identical objects", R"(Write only one copy of objects that are identical, such as
+fonts or images that were copied from several similar files.
+)");
 ap.addOptionHelp("--preserve-unreferenced", "transformation", "preserve unreferenced objects", R"(Preserve all objects from the input even if not referenced.
 )");
 ap.addOptionHelp("--remove-unreferenced-resources", "transformation", "remove unreferenced page resources", R"(--remove-unreferenced-resources=parameter
@@ -292,9 +363,6 @@ version. The version number format is
 to "major.minor" and the extension level, if specified, to
 "extension-level".
 )");
-}
-static void add_help_4(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--force-version", "transformation", "set output PDF version", R"(--force-version=version
 
 Force the output PDF file's PDF version header to be the specified
@@ -342,6 +410,9 @@ Specify the page range for the current page operation with
 with --pages and appears between --pages and --. Run
 qpdf --help=page-selection for details.
 )");
+}
+static void add_help_5(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--collate", "modification", "collate with --pages", R"(--collate[=n[,m,...]]
 
 Collate rather than concatenate pages specified with --pages.
@@ -427,9 +498,6 @@ Don't optimize images whose area in pixels is below the specified value.
 )");
 ap.addOptionHelp("--keep-inline-images", "modification", "exclude inline images from optimization", R"(Prevent inline images from being considered by --optimize-images.
 )");
-}
-static void add_help_5(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--remove-info", "modification", "remove file information", R"(Exclude file information (except modification date) from the output file.
 )");
 ap.addOptionHelp("--remove-metadata", "modification", "remove metadata", R"(Exclude metadata from the output file.
@@ -561,6 +629,9 @@ Values for modify-opt:
   annotate                 form + commenting and modifying forms
   all                      allow full document modification
 )");
+}
+static void add_help_6(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--user-password", "encryption", "specify user password", R"(--user-password=user-password
 
 Set the user password of the encrypted file.
@@ -650,9 +721,6 @@ version to be at least 1.6. This option is only available with
 128-bit encryption. The default is "n" for compatibility
 reasons. Use 256-bit encryption instead.
 )");
-}
-static void add_help_6(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--allow-insecure", "encryption", "allow empty owner passwords", R"(Allow creation of PDF files with empty owner passwords and
 non-empty user passwords when using 256-bit encryption.
 )");
@@ -753,6 +821,9 @@ Specify the range of pages in the primary output to apply
 overlay/underlay to. See qpdf --help=page-ranges for help with
 the page range syntax.
 )");
+}
+static void add_help_7(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--from", "overlay-underlay", "source pages for underlay/overlay", R"(--from=[page-range]
 
 Specify pages from the overlay/underlay file that are applied to
@@ -833,9 +904,6 @@ ap.addOptionHelp("--mimetype", "add-attachment", "attachment mime type, e.g. app
 Specify the mime type for the attachment, such as text/plain,
 application/pdf, image/png, etc.
 )");
-}
-static void add_help_7(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--description", "add-attachment", "set attachment's description", R"(--description="text"
 
 Supply descriptive text for the attachment, displayed by some
@@ -870,6 +938,9 @@ ap.addOptionHelp("--is-encrypted", "inspection", "silently test whether a file i
 This can be used with password-protected files even if you don't
 know the password.
 )");
+}
+static void add_help_8(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--requires-password", "inspection", "silently test a file's password", R"(Silently exit with a code indicating the file's password status:
 
 0: a password, other than as supplied, is required
@@ -927,9 +998,6 @@ object and for each content stream associated with the page.
 ap.addOptionHelp("--with-images", "inspection", "include image details with --show-pages", R"(When used with --show-pages, also shows the object and
 generation numbers for the image objects on each page.
 )");
-}
-static void add_help_8(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--list-attachments", "inspection", "list embedded files", R"(Show the key and stream number for each embedded file. Combine
 with --verbose for more detailed information.
 )");
@@ -961,6 +1029,9 @@ top-level keys will be included in the JSON output. Otherwise,
 all keys will be included. With --json-output, when not given,
 only the "qpdf" key will appear in the output.
 )");
+}
+static void add_help_9(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--json-object", "json", "limit which objects are in JSON", R"(--json-object={trailer|obj[,gen]}
 
 This option is repeatable. If given, only specified objects will
@@ -1039,6 +1110,7 @@ static void add_help(QPDFArgParser& ap)
     add_help_6(ap);
     add_help_7(ap);
     add_help_8(ap);
+    add_help_9(ap);
 ap.addHelpFooter("For detailed help, visit the qpdf manual: https://qpdf.readthedocs.io\n");
 }
 
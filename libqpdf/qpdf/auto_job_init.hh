@@ -43,6 +43,7 @@ this->ap.addBare("check-linearization", [this](){c_main->checkLinearization();})
 this->ap.addBare("coalesce-contents", [this](){c_main->coalesceContents();});
 this->ap.addBare("copy-attachments-from", b(&ArgParser::argCopyAttachmentsFrom));
 this->ap.addBare("decrypt", [this](){c_main->decrypt();});
+this->ap.addBare("deduplicate-objects", [this](){c_main->deduplicateObjects();});
 this->ap.addBare("deterministic-id", [this](){c_main->deterministicId();});
 this->ap.addBare("empty", b(&ArgParser::argEmpty));
 this->ap.addBare("encrypt", b(&ArgParser::argEncrypt));
@@ -51,10 +52,12 @@ this->ap.addBare("filtered-stream-data", [this](){c_main->filteredStreamData();}
 this->ap.addBare("flatten-rotation", [this](){c_main->flattenRotation();});
 this->ap.addBare("generate-appearances", [this](){c_main->generateAppearances();});
 this->ap.addBare("ignore-xref-streams", [this](){c_main->ignoreXrefStreams();});
+this->ap.addBare("incremental-update", [this](){c_main->incrementalUpdate();});
 this->ap.addBare("is-encrypted", [this](){c_main->isEncrypted();});
 this->ap.addBare("json-input", [this](){c_main->jsonInput();});
 this->ap.addBare("keep-inline-images", [this](){c_main->keepInlineImages();});
 this->ap.addBare("linearize", [this](){c_main->linearize();});
+this->ap.addBare("linearize-cache", [this](){c_main->linearizeCache();});
 this->ap.addBare("list-attachments", [this](){c_main->listAttachments();});
 this->ap.addBare("newline-before-endstream", [this](){c_main->newlineBeforeEndstream();});
 this->ap.addBare("no-original-object-ids", [this](){c_main->noOriginalObjectIds();});
@@ -88,11 +91,15 @@ this->ap.addBare("static-aes-iv", [this](){c_main->staticAesIv();});
 this->ap.addBare("static-id", [this](){c_main->staticId();});
 this->ap.addBare("suppress-password-recovery", [this](){c_main->suppressPasswordRecovery();});
 this->ap.addBare("suppress-recovery", [this](){c_main->suppressRecovery();});
+this->ap.addBare("sync-output", [this](){c_main->syncOutput();});
 this->ap.addBare("test-json-schema", [this](){c_main->testJsonSchema();});
 this->ap.addBare("underlay", b(&ArgParser::argUnderlay));
+this->ap.addBare("use-mmap", [this](){c_main->useMmap();});
+this->ap.addBare("use-object-arena", [this](){c_main->useObjectArena();});
 this->ap.addBare("verbose", [this](){c_main->verbose();});
 this->ap.addBare("warning-exit-0", [this](){c_main->warningExit0();});
 this->ap.addBare("with-images", [this](){c_main->withImages();});
+this->ap.addRequiredParameter("buffer-memory-limit", [this](std::string const& x){c_main->bufferMemoryLimit(x);}, "bytes");
 this->ap.addRequiredParameter("compression-level", [this](std::string const& x){c_main->compressionLevel(x);}, "level");
 this->ap.addRequiredParameter("jpeg-quality", [this](std::string const& x){c_main->jpegQuality(x);}, "level");
 this->ap.addRequiredParameter("copy-encryption", [this](std::string const& x){c_main->copyEncryption(x);}, "file");
@@ -100,21 +107,27 @@ this->ap.addRequiredParameter("encryption-file-password", [this](std::string con
 this->ap.addRequiredParameter("force-version", [this](std::string const& x){c_main->forceVersion(x);}, "version");
 this->ap.addRequiredParameter("ii-min-bytes", [this](std::string const& x){c_main->iiMinBytes(x);}, "minimum");
 this->ap.addRequiredParameter("job-json-file", [this](std::string const& x){c_main->jobJsonFile(x);}, "file");
+this->ap.addRequiredParameter("job-list", [this](std::string const& x){c_main->jobList(x);}, "file");
 this->ap.addRequiredParameter("json-object", [this](std::string const& x){c_main->jsonObject(x);}, "trailer");
 this->ap.addRequiredParameter("keep-files-open-threshold", [this](std::string const& x){c_main->keepFilesOpenThreshold(x);}, "count");
 this->ap.addRequiredParameter("linearize-pass1", [this](std::string const& x){c_main->linearizePass1(x);}, "filename");
 this->ap.addRequiredParameter("min-version", [this](std::string const& x){c_main->minVersion(x);}, "version");
+this->ap.addRequiredParameter("object-cache-limit", [this](std::string const& x){c_main->objectCacheLimit(x);}, "count");
 this->ap.addRequiredParameter("oi-min-area", [this](std::string const& x){c_main->oiMinArea(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-height", [this](std::string const& x){c_main->oiMinHeight(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-width", [this](std::string const& x){c_main->oiMinWidth(x);}, "minimum");
+this->ap.addRequiredParameter("output-buffer-size", [this](std::string const& x){c_main->outputBufferSize(x);}, "bytes");
 this->ap.addRequiredParameter("password", [this](std::string const& x){c_main->password(x);}, "password");
 this->ap.addRequiredParameter("password-file", [this](std::string const& x){c_main->passwordFile(x);}, "password");
 this->ap.addRequiredParameter("remove-attachment", [this](std::string const& x){c_main->removeAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("rotate", [this](std::string const& x){c_main->rotate(x);}, "[+|-]angle");
+this->ap.addRequiredParameter("serve", [this](std::string const& x){c_main->serve(x);}, "socket");
 this->ap.addRequiredParameter("show-attachment", [this](std::string const& x){c_main->showAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("show-object", [this](std::string const& x){c_main->showObject(x);}, "trailer");
 this->ap.addRequiredParameter("json-stream-prefix", [this](std::string const& x){c_main->jsonStreamPrefix(x);}, "stream-file-prefix");
+this->ap.addRequiredParameter("threads", [this](std::string const& x){c_main->threads(x);}, "count");
 this->ap.addRequiredParameter("update-from-json", [this](std::string const& x){c_main->updateFromJson(x);}, "qpdf-json file");
+this->ap.addRequiredParameter("write-statistics", [this](std::string const& x){c_main->writeStatistics(x);}, "file");
 this->ap.addOptionalParameter("collate", [this](std::string const& x){c_main->collate(x);});
 this->ap.addOptionalParameter("split-pages", [this](std::string const& x){c_main->splitPages(x);});
 this->ap.addChoices("compress-streams", [this](std::string const& x){c_main->compressStreams(x);}, true, yn_choices);
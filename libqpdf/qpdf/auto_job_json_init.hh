@@ -68,6 +68,9 @@ popHandler(); // key: decodeLevel
 pushKey("decrypt");
 addBare([this]() { c_main->decrypt(); });
 popHandler(); // key: decrypt
+pushKey("deduplicateObjects");
+addBare([this]() { c_main->deduplicateObjects(); });
+popHandler(); // key: deduplicateObjects
 pushKey("deterministicId");
 addBare([this]() { c_main->deterministicId(); });
 popHandler(); // key: deterministicId
@@ -89,6 +92,12 @@ popHandler(); // key: encryptionFilePassword
 pushKey("linearize");
 addBare([this]() { c_main->linearize(); });
 popHandler(); // key: linearize
+pushKey("linearizeCache");
+addBare([this]() { c_main->linearizeCache(); });
+popHandler(); // key: linearizeCache
+pushKey("incrementalUpdate");
+addBare([this]() { c_main->incrementalUpdate(); });
+popHandler(); // key: incrementalUpdate
 pushKey("linearizePass1");
 addParameter([this](std::string const& p) { c_main->linearizePass1(p); });
 popHandler(); // key: linearizePass1
@@ -104,6 +113,9 @@ popHandler(); // key: forceVersion
 pushKey("progress");
 addBare([this]() { c_main->progress(); });
 popHandler(); // key: progress
+pushKey("writeStatistics");
+addParameter([this](std::string const& p) { c_main->writeStatistics(p); });
+popHandler(); // key: writeStatistics
 pushKey("splitPages");
 addParameter([this](std::string const& p) { c_main->splitPages(p); });
 popHandler(); // key: splitPages
@@ -296,6 +308,27 @@ popHandler(); // key: testJsonSchema
 pushKey("ignoreXrefStreams");
 addBare([this]() { c_main->ignoreXrefStreams(); });
 popHandler(); // key: ignoreXrefStreams
+pushKey("useMmap");
+addBare([this]() { c_main->useMmap(); });
+popHandler(); // key: useMmap
+pushKey("useObjectArena");
+addBare([this]() { c_main->useObjectArena(); });
+popHandler(); // key: useObjectArena
+pushKey("threads");
+addParameter([this](std::string const& p) { c_main->threads(p); });
+popHandler(); // key: threads
+pushKey("objectCacheLimit");
+addParameter([this](std::string const& p) { c_main->objectCacheLimit(p); });
+popHandler(); // key: objectCacheLimit
+pushKey("bufferMemoryLimit");
+addParameter([this](std::string const& p) { c_main->bufferMemoryLimit(p); });
+popHandler(); // key: bufferMemoryLimit
+pushKey("outputBufferSize");
+addParameter([this](std::string const& p) { c_main->outputBufferSize(p); });
+popHandler(); // key: outputBufferSize
+pushKey("syncOutput");
+addBare([this]() { c_main->syncOutput(); });
+popHandler(); // key: syncOutput
 pushKey("passwordIsHexKey");
 addBare([this]() { c_main->passwordIsHexKey(); });
 popHandler(); // key: passwordIsHexKey
@@ -486,6 +519,10 @@ popHandler(); // key: warningExit0
 pushKey("jobJsonFile");
 addParameter([this](std::string const& p) { c_main->jobJsonFile(p); });
 popHandler(); // key: jobJsonFile
+pushKey("JobList");
+popHandler(); // key: JobList
+pushKey("Serve");
+popHandler(); // key: Serve
 pushKey("preserveUnreferencedResources");
 addBare([this]() { c_main->preserveUnreferencedResources(); });
 popHandler(); // key: preserveUnreferencedResources
@@ -15,6 +15,7 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "recompressFlate": "uncompress and recompress flate",
   "decodeLevel": "control which streams to uncompress",
   "decrypt": "remove encryption from input file",
+  "deduplicateObjects": "merge identical objects",
   "deterministicId": "generate ID deterministically",
   "staticAesIv": "use a fixed AES vector",
   "staticId": "use a fixed document ID",
@@ -22,11 +23,14 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "copyEncryption": "copy another file's encryption details",
   "encryptionFilePassword": "supply password for copyEncryption",
   "linearize": "linearize (web-optimize) output",
+  "linearizeCache": "keep objects in memory while linearizing",
+  "incrementalUpdate": "append changes to a copy of the input file",
   "linearizePass1": "save pass 1 of linearization",
   "objectStreams": "control use of object streams",
   "minVersion": "set minimum PDF version",
   "forceVersion": "set output PDF version",
   "progress": "show progress when writing",
+  "writeStatistics": "write timing and stream statistics as JSON",
   "splitPages": "write pages to separate files",
   "jsonOutput": "apply defaults for JSON serialization",
   "removeRestrictions": "remove security restrictions from input file",
@@ -98,6 +102,13 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "verbose": "print additional information",
   "testJsonSchema": "test generated json against schema",
   "ignoreXrefStreams": "use xref tables rather than streams",
+  "useMmap": "map input files into memory",
+  "useObjectArena": "allocate objects from a memory pool",
+  "threads": "use worker threads",
+  "objectCacheLimit": "limit objects kept in memory",
+  "bufferMemoryLimit": "limit memory used for stream data when writing",
+  "outputBufferSize": "buffer output before writing it",
+  "syncOutput": "write output file to storage before exiting",
   "passwordIsHexKey": "provide hex-encoded encryption key",
   "passwordMode": "tweak how qpdf encodes passwords",
   "suppressPasswordRecovery": "don't try different password encodings",
@@ -177,6 +188,8 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   ],
   "warningExit0": "exit 0 even with warnings",
   "jobJsonFile": "job JSON file",
+  "JobList": null,
+  "Serve": null,
   "preserveUnreferencedResources": "use removeUnreferencedResources=no",
   "requiresPassword": "silently test a file's password",
   "isEncrypted": "silently test whether a file is encrypted"
@@ -0,0 +1,70 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/CompactMap.hh>
+
+#include <iostream>
+#include <string>
+
+using Map = CompactMap<std::string, int, 4>;
+
+static void
+dump(Map const& m)
+{
+    for (auto const& [key, value]: m) {
+        std::cout << key << " : " << value << "\n";
+    }
+    std::cout << "size: " << m.size() << "\n";
+}
+
+int
+main()
+{
+    Map m;
+    assert(m.empty());
+    assert(m.begin() == m.end());
+
+    // Insert out of order. Iteration is in key order.
+    for (auto const& key: {"/Type", "/Length", "/Filter"}) {
+        m[key] = static_cast<int>(std::string(key).size());
+    }
+    assert(m.try_emplace("/Type", 0).second == false);
+    assert(m.insert_or_assign("/Type", 1).second == false);
+    assert(m["/Type"] == 1);
+    assert(m.contains("/Filter"));
+    assert(!m.contains("/DecodeParms"));
+    assert(m.find("/Length")->second == 7);
+    dump(m);
+
+    // Growing beyond the threshold switches to a std::map without changing the order.
+    std::cout << "grow\n";
+    for (auto const& key: {"/D", "/C", "/B", "/A"}) {
+        m.try_emplace(key, 0);
+    }
+    dump(m);
+    assert(m.erase("/C") == 1);
+    assert(m.erase("/C") == 0);
+    assert(!m.contains("/C"));
+
+    // Copies are deep.
+    auto copy = m;
+    copy["/B"] = 2;
+    assert(m["/B"] == 0);
+
+    std::cout << "reverse\n";
+    for (auto it = m.crbegin(); it != m.crend(); ++it) {
+        std::cout << it->first << "\n";
+    }
+
+    auto as_map = m.as_map();
+    assert(as_map.size() == m.size());
+    assert(Map(as_map).size() == m.size());
+
+    m.clear();
+    assert(m.empty());
+    assert(m.erase("/Type") == 0);
+    m["/Type"] = 3;
+    dump(m);
+
+    std::cout << "compact map tests done\n";
+    return 0;
+}
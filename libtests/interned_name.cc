@@ -0,0 +1,74 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/CompactMap.hh>
+#include <qpdf/InternedName.hh>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int
+main()
+{
+    auto base = InternedName::table_size();
+    {
+        InternedName a("/Type");
+        InternedName b(std::string("/Ty") + "pe");
+        InternedName c("/Subtype");
+        assert(InternedName::table_size() == base + 2);
+        assert(a == b);
+        assert(a != c);
+        assert(a == "/Type");
+        assert(std::string("/Type") == a);
+        assert(c < a);
+        assert(a > "/Subtype");
+        assert(&a.str() == &b.str());
+        std::string s = a;
+        assert(s == "/Type");
+
+        // Copies and moves share the entry.
+        auto d = a;
+        auto e = std::move(b);
+        assert(d == e);
+        e = c;
+        assert(e == "/Subtype");
+        assert(InternedName::table_size() == base + 2);
+
+        InternedName empty;
+        assert(empty.str().empty());
+        assert(empty == "");
+        assert(empty < a);
+    }
+    // The last reference releases the entry.
+    assert(InternedName::table_size() == base);
+
+    // A map keyed by InternedName can be searched with strings.
+    CompactMap<InternedName, int> m;
+    m[std::string("/Length")] = 1;
+    m.insert_or_assign(InternedName("/Filter"), 2);
+    assert(m.contains(std::string("/Length")));
+    assert(m.find(InternedName("/Filter"))->second == 2);
+    assert(m.erase(std::string("/Length")) == 1);
+    assert(!m.contains(std::string("/Length")));
+
+    // Names may be created and released concurrently.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 10000; ++i) {
+                InternedName n("/N" + std::to_string(i % 100));
+                auto copy = n;
+                assert(copy == n);
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    m.clear();
+    assert(InternedName::table_size() == base);
+
+    std::cout << "interned name tests done\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/ObjGenTable.hh>
+
+#include <iostream>
+#include <string>
+
+static void
+dump(ObjGenTable<int> const& table)
+{
+    for (auto const& [og, value]: table) {
+        std::cout << og.unparse(' ') << " : " << value << "\n";
+    }
+    std::cout << "size: " << table.size() << ", last: " << table.last().unparse(' ') << "\n";
+}
+
+int
+main()
+{
+    ObjGenTable<int> table;
+    assert(table.empty());
+    assert(table.begin() == table.end());
+
+    // Insert out of order, with multiple generations and some ids that are too large to be kept in
+    // the vector.
+    for (int i: {5, 3, 1, 2, 4}) {
+        table[QPDFObjGen(i, 0)] = 10 * i;
+    }
+    table[QPDFObjGen(3, 2)] = 32;
+    table[QPDFObjGen(3, 1)] = 31;
+    table.try_emplace(QPDFObjGen(100000, 0), 7);
+    table.insert({QPDFObjGen(80, 0), 8});
+    assert(!table.try_emplace(QPDFObjGen(80, 0), 9).second);
+    assert(table[QPDFObjGen(80, 0)] == 8);
+    dump(table);
+
+    assert(table.contains(QPDFObjGen(3, 1)));
+    assert(!table.contains(QPDFObjGen(3, 3)));
+    assert(table.find(QPDFObjGen(6, 0)) == table.end());
+    assert(table.find(QPDFObjGen(3, 2))->second == 32);
+    assert(table.has_later_generation(QPDFObjGen(3, 0)));
+    assert(table.has_later_generation(QPDFObjGen(3, 1)));
+    assert(!table.has_later_generation(QPDFObjGen(3, 2)));
+    assert(!table.has_later_generation(QPDFObjGen(4, 0)));
+
+    // Iterators remain valid while other elements are inserted or erased.
+    std::cout << "erase while iterating\n";
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        if (it->first.getObj() == 3 && it->first.getGen() > 0) {
+            table.erase(QPDFObjGen(3, it->first.getGen() - 1));
+        }
+        if (it->first.getObj() == 4) {
+            table[QPDFObjGen(3000, 0)] = 300;
+            table[QPDFObjGen(2, 1)] = 21;
+        }
+    }
+    dump(table);
+
+    // Erase the element following the current one, switching between dense slots and sparse
+    // elements in both directions.
+    std::cout << "erase next element while iterating\n";
+    {
+        ObjGenTable<int> t;
+        for (int i: {1, 2, 3}) {
+            t[QPDFObjGen(i, 0)] = 10 * i;
+        }
+        t[QPDFObjGen(1, 1)] = 11;
+        t[QPDFObjGen(1, 2)] = 12;
+        t[QPDFObjGen(100000, 0)] = 7;
+        for (auto it = t.begin(); it != t.end(); ++it) {
+            std::cout << "visit " << it->first.unparse(' ') << "\n";
+            if (it->first == QPDFObjGen(1, 0)) {
+                t.erase(QPDFObjGen(1, 1));
+            } else if (it->first == QPDFObjGen(1, 2)) {
+                t.erase(QPDFObjGen(2, 0));
+            } else if (it->first == QPDFObjGen(3, 0)) {
+                t.erase(QPDFObjGen(100000, 0));
+            }
+        }
+        dump(t);
+    }
+
+    std::cout << "erase by iterator\n";
+    table.erase(table.find(QPDFObjGen(100000, 0)));
+    table.erase(table.find(QPDFObjGen(1, 0)));
+    assert(table.erase(QPDFObjGen(1, 0)) == 0);
+    assert(table.erase(QPDFObjGen(3000, 0)) == 1);
+    dump(table);
+
+    std::cout << "reserve\n";
+    for (int i = 200; i > 100; --i) {
+        table[QPDFObjGen(i, 0)] = i;
+    }
+    table.reserve(201);
+    assert(table.size() == 106);
+    assert(table.last() == QPDFObjGen(200, 0));
+    int count = 0;
+    QPDFObjGen prev;
+    for (auto const& [og, value]: table) {
+        assert(prev < og);
+        prev = og;
+        ++count;
+    }
+    assert(count == 106);
+
+    table.clear();
+    assert(table.empty());
+    assert(table.begin() == table.end());
+
+    std::cout << "objgen table tests done\n";
+    return 0;
+}
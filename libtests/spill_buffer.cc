@@ -0,0 +1,78 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/Pl_SpillBuffer.hh>
+#include <qpdf/Pl_String.hh>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+static std::string
+contents(Pl_SpillBuffer& b)
+{
+    std::string result;
+    Pl_String s("contents", nullptr, result);
+    b.writeTo(s);
+    return result;
+}
+
+int
+main()
+{
+    // Without a limit, everything stays in memory.
+    Pl_SpillBuffer b1("unlimited", 0);
+    assert(b1.empty());
+    assert(b1.back() == '\0');
+    for (int i = 0; i < 1000; ++i) {
+        b1.writeString("0123456789");
+    }
+    b1.finish();
+    assert(!b1.spilled());
+    assert(b1.size() == 10000);
+    assert(b1.back() == '9');
+    auto s = b1.getString();
+    assert(s.size() == 10000);
+    assert(b1.empty());
+
+    // Data is moved to a file once the limit is exceeded.
+    Pl_SpillBuffer b2("limited", 15);
+    b2.writeString("potato ");
+    b2.writeString("salad");
+    assert(!b2.spilled());
+    b2.writeString(" with mayonnaise");
+    assert(b2.spilled());
+    assert(b2.size() == 28);
+    assert(b2.back() == 'e');
+    assert(contents(b2) == "potato salad with mayonnaise");
+    // Writing after writeTo appends, and the data can be written again.
+    b2.writeString("!");
+    b2.finish();
+    assert(contents(b2) == "potato salad with mayonnaise!");
+    assert(contents(b2) == "potato salad with mayonnaise!");
+    try {
+        b2.getString();
+        assert(false);
+    } catch (std::logic_error&) {
+        std::cout << "getString after spill throws" << '\n';
+    }
+
+    // Clearing starts over in memory.
+    b2.clear();
+    assert(!b2.spilled());
+    assert(b2.empty());
+    b2.writeString("quack");
+    assert(!b2.spilled());
+    assert(contents(b2) == "quack");
+
+    // Assigned data is kept in memory regardless of the limit.
+    b2.assign(std::string(100, 'x'));
+    assert(!b2.spilled());
+    assert(b2.size() == 100);
+    assert(b2.back() == 'x');
+    b2.writeString("y");
+    assert(b2.spilled());
+    assert(contents(b2) == std::string(100, 'x') + "y");
+
+    std::cout << "done" << '\n';
+    return 0;
+}
@@ -0,0 +1,9 @@
+use strict;
+use warnings;
+
+# Times vary from run to run.
+while (<>)
+{
+    s/"(cpuTime|wallTime)": .*?(,?)$/"$1": 0$2/;
+    print;
+}
@@ -0,0 +1,38 @@
+# Send the contents of a file as a request to a qpdf --serve socket and print the response.
+use warnings;
+use strict;
+use IO::Socket::UNIX;
+use Socket;
+
+# With --large instead of a file, send a request that is too large.
+if (@ARGV != 2)
+{
+    die "Usage: $0 socket {request-file|--large}\n";
+}
+my ($socket, $request_file) = @ARGV;
+
+# The server may still be starting.
+my $s;
+for (my $i = 0; $i < 100; ++$i)
+{
+    $s = IO::Socket::UNIX->new(Type => SOCK_STREAM(), Peer => $socket);
+    last if $s;
+    select(undef, undef, undef, 0.1);
+}
+$s or die "$0: unable to connect to $socket: $!\n";
+
+my $request;
+if ($request_file eq '--large')
+{
+    $request = ' ' x (17 << 20);
+}
+else
+{
+    open(F, "<$request_file") or die "$0: can't open $request_file: $!\n";
+    local $/ = undef;
+    $request = <F>;
+    close(F);
+}
+print $s $request;
+$s->shutdown(1);
+print <$s>;
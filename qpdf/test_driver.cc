@@ -3559,6 +3559,113 @@ test_100(QPDF& pdf, char const* arg2)
     }
 }
 
+static void
+test_101(QPDF& pdf, char const* arg2)
+{
+    // Test incremental updates. This test is designed for minimal.pdf.
+    auto page = pdf.getAllPages().at(0);
+    // Change a direct object inside the page, which has to be found by comparing the page with the
+    // input file.
+    page.getKey("/MediaBox").setArrayItem(2, QPDFObjectHandle::newInteger(595));
+    page.getKey("/Contents")
+        .replaceStreamData(
+            "BT /F1 12 Tf 72 720 Td (Salad) Tj ET\n",
+            QPDFObjectHandle::newNull(),
+            QPDFObjectHandle::newNull());
+    pdf.getRoot().replaceKey("/QTest", pdf.makeIndirectObject("<< /A (new) >>"_qpdf));
+    QPDFWriter w(pdf, "a.pdf");
+    w.setIncrementalUpdate(true);
+    w.setStaticID(true);
+    w.write();
+
+    QPDFWriter w2(pdf, "b.pdf");
+    w2.setIncrementalUpdate(true);
+    w2.setLinearization(true);
+    try {
+        w2.write();
+        std::cout << "linearized incremental update succeeded" << '\n';
+    } catch (std::logic_error& e) {
+        std::cout << "logic error: " << e.what() << '\n';
+    }
+}
+
+static void
+test_102(QPDF& pdf, char const* arg2)
+{
+    // Test the unparsed object cache. Writing with the cache enabled must give the same output as
+    // writing without it, including after changes that invalidate cached objects.
+    auto write = [&pdf](bool linearize) {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setStaticID(true);
+        w.setObjectStreamMode(qpdf_o_generate);
+        w.setLinearization(linearize);
+        w.write();
+        auto b = w.getBufferSharedPointer();
+        return std::string(reinterpret_cast<char*>(b->getBuffer()), b->getSize());
+    };
+    auto check = [&pdf, &write](char const* what) {
+        pdf.setUnparsedObjectCache(false);
+        auto expected = write(false);
+        auto expected_lin = write(true);
+        pdf.setUnparsedObjectCache(true);
+        for (int i = 0; i < 2; ++i) {
+            if (write(false) != expected || write(true) != expected_lin) {
+                std::cout << what << ": output differs with unparsed object cache" << '\n';
+                return;
+            }
+        }
+        std::cout << what << ": output is the same" << '\n';
+    };
+
+    // Linearizing pushes inherited attributes to the pages, which changes the output.
+    write(true);
+    check("unchanged");
+
+    auto pages = pdf.getAllPages();
+    pages.at(0).replaceKey("/Rotate", QPDFObjectHandle::newInteger(90));
+    check("indirect object modified");
+
+    pages.at(1).getKey("/MediaBox").setArrayItem(2, QPDFObjectHandle::newInteger(595));
+    check("direct object modified");
+
+    pdf.getRoot().replaceKey("/QTest", pdf.makeIndirectObject("<< /A (new) >>"_qpdf));
+    check("objects renumbered");
+
+    pages.at(2).replaceKey("/QTest", QPDFObjectHandle::newArray());
+    check("new direct object");
+    pages.at(2).getKey("/QTest").appendItem(QPDFObjectHandle::newInteger(1));
+    check("new direct object modified");
+
+    pdf.swapObjects(pages.at(3).getObjGen(), pages.at(4).getObjGen());
+    check("objects swapped");
+}
+
+static void
+test_103(QPDF& pdf, char const* arg2)
+{
+    // Changes to direct objects must not be lost when objects are evicted from the object cache.
+    // This test is designed for 11-pages-with-labels.pdf.
+    pdf.setObjectCacheLimit(1);
+    auto pages = pdf.getAllPages();
+    for (size_t i = 0; i < 6; ++i) {
+        pages.at(i).getKey("/MediaBox").setArrayItem(2, QPDFObjectHandle::newInteger(595));
+        pdf.trimObjectCache();
+    }
+    QPDFWriter w(pdf);
+    w.setOutputMemory();
+    w.setStaticID(true);
+    w.write();
+    auto b = w.getBufferSharedPointer();
+
+    QPDF out;
+    out.processMemoryFile("out", reinterpret_cast<char*>(b->getBuffer()), b->getSize());
+    int n = 0;
+    for (auto& page: out.getAllPages()) {
+        std::cout << "page " << ++n << ": " << page.getKey("/MediaBox").unparse() << '\n';
+    }
+}
+
 void
 runtest(int n, char const* filename1, char const* arg2)
 {
@@ -3656,7 +3763,8 @@ runtest(int n, char const* filename1, char const* arg2)
         {78, test_78}, {79, test_79}, {80, test_80}, {81, test_81}, {82, test_82},  {83, test_83},
         {84, test_84}, {85, test_85}, {86, test_86}, {87, test_87}, {88, test_88},  {89, test_89},
         {90, test_90}, {91, test_91}, {92, test_92}, {93, test_93}, {94, test_94},  {95, test_95},
-        {96, test_96}, {97, test_97}, {98, test_98}, {99, test_99}, {100, test_100}};
+        {96, test_96}, {97, test_97}, {98, test_98}, {99, test_99}, {100, test_100},
+        {101, test_101}, {102, test_102}, {103, test_103}};
 
     auto fn = test_functions.find(n);
     if (fn == test_functions.end()) {